@@ -10,6 +10,7 @@
 #include <float.h>
 #include <stdlib.h>
 #include <conio.h>
+#include "ma_grid.h"
 
 
 /*
@@ -79,69 +80,37 @@ double opt_params (
    int *long_term     // Returns optimal long-term lookback
    )
 {
-   int i, j, ishort, ilong, ibestshort, ibestlong, traded, n_trades ;
-   double short_sum, long_sum, short_mean, long_mean, total_return, best_perf ;
-   double ret, win_sum, lose_sum, sum_squares, sr ;
+   int ishort, ilong, ipair, ibestshort, ibestlong, n_trades ;
+   double total_return, best_perf, win_sum, lose_sum, sum_squares, sr ;
+   MaGrid grid ;
 
-   best_perf = -1.e60 ;                          // Will be best performance across all trials
-   for (ilong=2 ; ilong<200 ; ilong++) {         // Trial long-term lookback
-      for (ishort=1 ; ishort<ilong ; ishort++) { // Trial short-term lookback
-
-         // We have a pair of lookbacks to try.
-         // Cumulate performance for all valid cases
-
-         total_return = 0.0 ;                    // Cumulate total return for this trial
-         win_sum = lose_sum = 1.e-60 ;           // Cumulates for profit factor
-         sum_squares = 1.e-60 ;                  // Cumulates for Sharpe ratio
-         n_trades = 0 ;                          // Will count trades
-
-         for (i=ilong-1 ; i<ncases-1 ; i++) {    // Compute performance across history
-
-            if (i == ilong-1) { // Find the short-term and long-term moving averages for the first valid case.
-               short_sum = 0.0 ;                 // Cumulates short-term lookback sum
-               for (j=i ; j>i-ishort ; j--)
-                  short_sum += x[j] ;
-               long_sum = short_sum ;            // Cumulates long-term lookback sum
-               while (j>i-ilong)
-                  long_sum += x[j--] ;
-               }
-
-            else {                               // Update the moving averages
-               short_sum += x[i] - x[i-ishort] ;
-               long_sum += x[i] - x[i-ilong] ;
-               }
-
-            short_mean = short_sum / ishort ;
-            long_mean = long_sum / ilong ;
-
-            // We now have the short-term and long-term moving averages ending at day i
-            // Take our position and cumulate performance
+   if (ma_grid_alloc ( &grid , 199 , 1 )) {
+      printf ( "\n\nInsufficient memory" ) ;
+      exit ( 1 ) ;
+      }
 
-            traded = 0 ;                                            // Did we do a trade?
-            if (long_v_short  &&  short_mean > long_mean) {         // Long position
-               ret = x[i+1] - x[i] ;
-               traded = 1 ;
-               }
-            else if (! long_v_short  &&  short_mean < long_mean) {  // Short position
-               ret = x[i] - x[i+1] ;
-               traded = 1 ;
-               }
+   // Cumulate performance of every pair of lookbacks for all valid cases,
+   // each starting at its first valid case ilong-1.
+   // Win_sum, lose_sum and sum_squares start at 1.e-60.
 
-            if (traded) {
-               ++n_trades ;
-               total_return += ret ;
-               sum_squares += ret * ret ;
-               if (ret > 0.0)
-                  win_sum += ret ;
-               else
-                  lose_sum -= ret ;
-               }
+   ma_grid_start ( &grid , x , 0 , long_v_short ? MA_GRID_LONG_ONLY : MA_GRID_SHORT_ONLY , 1.e-60 ) ;
+   ma_grid_run ( &grid , x , ncases-1 , (double *) NULL , 0 ) ;
 
-            } // For i, summing performance for this trial
+   best_perf = -1.e60 ;                          // Will be best performance across all trials
+   ipair = 0 ;
+   for (ilong=2 ; ilong<200 ; ilong++) {         // Trial long-term lookback
+      for (ishort=1 ; ishort<ilong ; ishort++) { // Trial short-term lookback
 
          // We now have the performance figures across the history
          // Keep track of the best lookbacks
 
+         total_return = grid.total[ipair] ;
+         win_sum = grid.win_sum[ipair] ;
+         lose_sum = grid.lose_sum[ipair] ;
+         sum_squares = grid.sum_sq[ipair] ;
+         n_trades = (int) (grid.n_long[ipair] + grid.n_short[ipair]) ;
+         ++ipair ;
+
          if (which == 0) {      // Mean return criterion
             total_return /= n_trades + 1.e-30 ;
             if (total_return > best_perf) {
@@ -174,6 +143,8 @@ double opt_params (
          } // For ishort, all short-term lookbacks
       } // For ilong, all long-term lookbacks
 
+   ma_grid_free ( &grid ) ;
+
    *short_term = ibestshort ;
    *long_term = ibestlong ;
 
@@ -0,0 +1,377 @@
+// Binary columnar market history (.bars files)
+//
+// The algorithm programs normally re-parse a text history on every run.
+// A .bars file holds the same data as typed columns so a run only has to
+// map the file and page it in. Build one with tools/txt_to_bars.
+//
+// Layout (host byte order, which is little-endian on every supported target):
+//   BarStoreHeader                 fixed size, starts with BAR_STORE_MAGIC
+//   one array per present column   8-byte aligned, at header.column_offset[col]
+//
+// Columns:
+//   BAR_COL_DATE       int32   YYYYMMDD
+//   BAR_COL_OPEN .. BAR_COL_VOLUME   double
+//   BAR_COL_TIMESTAMP  int64   epoch milliseconds, UTC (see bar_time.h)
+//
+// header.checksum is a word-wise FNV-1a 64 over every present column, in
+// column-index order. Readers refuse files whose checksum does not match.
+//
+// Single-price programs read the first price after the date (line+9 in the
+// text readers). For a store that is the open column; txt_to_bars fills all
+// four price columns from a "YYYYMMDD price" line, so both formats agree.
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <string>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define BAR_STORE_MAGIC "MKTBARS"   // 7 chars + NUL fill the 8-byte magic
+#define BAR_STORE_VERSION 1
+#define BAR_STORE_MAX_COLUMNS 16    // Room for later columns without a new header
+
+enum BarStoreColumn {
+  BAR_COL_DATE = 0,
+  BAR_COL_OPEN,
+  BAR_COL_HIGH,
+  BAR_COL_LOW,
+  BAR_COL_CLOSE,
+  BAR_COL_VOLUME,
+  BAR_COL_TIMESTAMP,
+  BAR_COL_COUNT
+};
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t header_bytes;
+  uint64_t nrows;
+  uint64_t checksum;
+  uint64_t column_offset[BAR_STORE_MAX_COLUMNS];  // 0 = column absent
+} BarStoreHeader;
+
+// Read-only view of an open store. Column pointers are NULL when absent.
+typedef struct {
+  int64_t nrows;
+  const int32_t *date;
+  const double *open;
+  const double *high;
+  const double *low;
+  const double *close;
+  const double *volume;
+  const int64_t *timestamp;
+
+  // Private: backing memory
+  void *base;
+  size_t bytes;
+  int mapped;
+} BarStore;
+
+static inline size_t bar_store_column_width(int col) {
+  if (col == BAR_COL_DATE) return sizeof(int32_t);
+  if (col == BAR_COL_TIMESTAMP) return sizeof(int64_t);
+  return sizeof(double);
+}
+
+// FNV-1a step applied to whole 8-byte words (a trailing partial word is
+// zero-padded), so verifying a large store costs about as much as reading it
+static inline uint64_t bar_store_fnv1a(uint64_t hash, const void *data, size_t n) {
+  const unsigned char *p = (const unsigned char *) data;
+  uint64_t word;
+  for (; n >= 8; p += 8, n -= 8) {
+    memcpy(&word, p, 8);
+    hash ^= word;
+    hash *= 1099511628211ULL;
+  }
+  if (n > 0) {
+    word = 0;
+    memcpy(&word, p, n);
+    hash ^= word;
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+
+#define BAR_STORE_FNV_OFFSET 14695981039346656037ULL
+
+// Nonzero if the file starts with the bar store magic (text files never do)
+static inline int bar_store_is_binary(const char *filename) {
+  char magic[8];
+  FILE *fp = fopen(filename, "rb");
+  if (fp == NULL) return 0;
+  size_t got = fread(magic, 1, sizeof(magic), fp);
+  fclose(fp);
+  return got == sizeof(magic) && memcmp(magic, BAR_STORE_MAGIC, sizeof(magic)) == 0;
+}
+
+static inline void bar_store_close(BarStore *store) {
+  if (store->base != NULL) {
+#if !defined(_WIN32)
+    if (store->mapped)
+      munmap(store->base, store->bytes);
+    else
+#endif
+      free(store->base);
+  }
+  memset(store, 0, sizeof(*store));
+}
+
+// Error text for the reader and writer: what + filename (+ rest). The path can
+// be any length, so this builds a std::string rather than filling a buffer.
+static inline int bar_store_error(std::string *err, const char *what, const char *filename, const char *rest = "") {
+  if (err != NULL) *err = std::string(what) + filename + rest;
+  return 1;
+}
+
+// Map (or, without mmap, read) a store and validate it.
+// Returns 0 on success; otherwise sets *err (if not NULL) and returns 1.
+static inline int bar_store_open(const char *filename, BarStore *store, std::string *err) {
+  memset(store, 0, sizeof(*store));
+
+#if !defined(_WIN32)
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    return bar_store_error(err, "Cannot open bar store ", filename);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(BarStoreHeader)) {
+    close(fd);
+    return bar_store_error(err, "Bar store ", filename, " is truncated");
+  }
+  store->bytes = (size_t) st.st_size;
+  store->base = mmap(NULL, store->bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (store->base == MAP_FAILED) {
+    store->base = NULL;
+    return bar_store_error(err, "Cannot map bar store ", filename);
+  }
+  store->mapped = 1;
+#ifdef MADV_SEQUENTIAL
+  madvise(store->base, store->bytes, MADV_SEQUENTIAL);
+#endif
+#else
+  FILE *fp = fopen(filename, "rb");
+  if (fp == NULL) {
+    return bar_store_error(err, "Cannot open bar store ", filename);
+  }
+  fseek(fp, 0, SEEK_END);
+  long size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  if (size < (long) sizeof(BarStoreHeader)) {
+    fclose(fp);
+    return bar_store_error(err, "Bar store ", filename, " is truncated");
+  }
+  store->bytes = (size_t) size;
+  store->base = malloc(store->bytes);
+  if (store->base == NULL || fread(store->base, 1, store->bytes, fp) != store->bytes) {
+    fclose(fp);
+    bar_store_close(store);
+    return bar_store_error(err, "Cannot read bar store ", filename);
+  }
+  fclose(fp);
+#endif
+
+  const BarStoreHeader *hdr = (const BarStoreHeader *) store->base;
+  if (memcmp(hdr->magic, BAR_STORE_MAGIC, sizeof(hdr->magic)) != 0
+   || hdr->version != BAR_STORE_VERSION
+   || hdr->header_bytes != sizeof(BarStoreHeader)) {
+    bar_store_close(store);
+    return bar_store_error(err, "", filename, (" is not a version " + std::to_string(BAR_STORE_VERSION) + " bar store").c_str());
+  }
+
+  const char *bytes = (const char *) store->base;
+  const void *cols[BAR_STORE_MAX_COLUMNS] = {0};
+  uint64_t checksum = BAR_STORE_FNV_OFFSET;
+  for (int col = 0; col < BAR_COL_COUNT; ++col) {
+    uint64_t offset = hdr->column_offset[col];
+    if (offset == 0) continue;
+    uint64_t len = hdr->nrows * bar_store_column_width(col);
+    if (offset % 8 != 0 || offset < sizeof(BarStoreHeader) || offset > store->bytes
+     || len > store->bytes - offset) {
+      bar_store_close(store);
+      return bar_store_error(err, "Bar store ", filename, " is truncated or corrupt");
+    }
+    cols[col] = bytes + offset;
+    checksum = bar_store_fnv1a(checksum, cols[col], (size_t) len);
+  }
+
+  if (checksum != hdr->checksum) {
+    bar_store_close(store);
+    return bar_store_error(err, "Checksum mismatch in bar store ", filename);
+  }
+
+  store->nrows = (int64_t) hdr->nrows;
+  store->date = (const int32_t *) cols[BAR_COL_DATE];
+  store->open = (const double *) cols[BAR_COL_OPEN];
+  store->high = (const double *) cols[BAR_COL_HIGH];
+  store->low = (const double *) cols[BAR_COL_LOW];
+  store->close = (const double *) cols[BAR_COL_CLOSE];
+  store->volume = (const double *) cols[BAR_COL_VOLUME];
+  store->timestamp = (const int64_t *) cols[BAR_COL_TIMESTAMP];
+  return 0;
+}
+
+// Write a store. Any column pointer may be NULL to omit that column.
+// Returns 0 on success; otherwise sets *err (if not NULL) and returns 1.
+static inline int bar_store_write(const char *filename, int64_t nrows, const int32_t *date,
+                                  const double *open, const double *high, const double *low,
+                                  const double *close, const double *volume,
+                                  const int64_t *timestamp,
+                                  std::string *err) {
+  const void *cols[BAR_COL_COUNT] = {date, open, high, low, close, volume, timestamp};
+  BarStoreHeader hdr;
+  memset(&hdr, 0, sizeof(hdr));
+  memcpy(hdr.magic, BAR_STORE_MAGIC, sizeof(hdr.magic));
+  hdr.version = BAR_STORE_VERSION;
+  hdr.header_bytes = sizeof(BarStoreHeader);
+  hdr.nrows = (uint64_t) nrows;
+  hdr.checksum = BAR_STORE_FNV_OFFSET;
+
+  uint64_t offset = sizeof(BarStoreHeader);
+  for (int col = 0; col < BAR_COL_COUNT; ++col) {
+    if (cols[col] == NULL) continue;
+    offset = (offset + 7) & ~(uint64_t) 7;
+    hdr.column_offset[col] = offset;
+    size_t len = (size_t) nrows * bar_store_column_width(col);
+    hdr.checksum = bar_store_fnv1a(hdr.checksum, cols[col], len);
+    offset += len;
+  }
+
+  FILE *fp = fopen(filename, "wb");
+  if (fp == NULL) {
+    return bar_store_error(err, "Cannot create bar store ", filename);
+  }
+
+  static const char zeros[8] = {0};
+  int ok = fwrite(&hdr, sizeof(hdr), 1, fp) == 1;
+  uint64_t pos = sizeof(BarStoreHeader);
+  for (int col = 0; ok && col < BAR_COL_COUNT; ++col) {
+    if (cols[col] == NULL) continue;
+    size_t pad = (size_t) (hdr.column_offset[col] - pos);
+    size_t len = (size_t) nrows * bar_store_column_width(col);
+    ok = (pad == 0 || fwrite(zeros, 1, pad, fp) == pad)
+      && (len == 0 || fwrite(cols[col], 1, len, fp) == len);
+    pos = hdr.column_offset[col] + len;
+  }
+
+  if (fclose(fp) != 0) ok = 0;
+  if (!ok) {
+    return bar_store_error(err, "Error writing bar store ", filename);
+  }
+  return 0;
+}
+
+// Nonzero if a bar's prices are consistent: low <= open, close <= high.
+// txt_to_bars refuses rows that fail this, and bar_store_load re-checks it so
+// a store from anywhere gets the same test as the OHLC text readers.
+static inline int bar_store_ohlc_ok(double open, double high, double low, double close) {
+  return !(low > open || low > close || high < open || high < close);
+}
+
+// Nonzero if a YYYYMMDD date passes the text readers' range check
+static inline int bar_store_date_ok(int date) {
+  int year = date / 10000, month = date / 100 % 100, day = date % 100;
+  return !(month < 1 || month > 12 || day < 1 || day > 31 || year < 1800 || year > 2030);
+}
+
+// The binary branch of the algorithm mains' market readers: copy the
+// requested columns of a store into malloc'd arrays (release with free(),
+// exactly like the text readers' buffers). Pass NULL for columns that are not
+// needed. With log_prices set, positive prices are replaced by their log, as
+// the text readers do. Every row must pass bar_store_ohlc_ok; with check_dates
+// set, dates must also be valid and increasing (ENTROPY and STATN check this
+// on text input too).
+// Returns 0 on success; otherwise prints a message and returns 1.
+static inline int bar_store_load(const char *filename, int *nrows, int **date,
+                                 double **open, double **high, double **low, double **close,
+                                 int log_prices, int check_dates) {
+  printf("\nReading binary market file...");
+
+  std::string err;
+  BarStore store;
+  if (bar_store_open(filename, &store, &err)) {
+    printf("\n\n%s", err.c_str());
+    return 1;
+  }
+  if (store.nrows > INT_MAX) {
+    printf("\n\nBar store %s has too many rows", filename);
+    bar_store_close(&store);
+    return 1;
+  }
+
+  int n = (int) store.nrows;
+  double **dst[4] = {open, high, low, close};
+  const double *src[4] = {store.open, store.high, store.low, store.close};
+
+  if (store.open != NULL && store.high != NULL && store.low != NULL && store.close != NULL) {
+    for (int i = 0; i < n; ++i) {
+      if (!bar_store_ohlc_ok(store.open[i], store.high[i], store.low[i], store.close[i])) {
+        printf("\nInvalid open/high/low/close in row %d of file %s", i + 1, filename);
+        bar_store_close(&store);
+        return 1;
+      }
+    }
+  }
+
+  if (check_dates && store.date != NULL) {
+    int prior_date = 0;
+    for (int i = 0; i < n; ++i) {
+      if (!bar_store_date_ok(store.date[i])) {
+        printf("\nERROR... Invalid date %d in row %d", store.date[i], i + 1);
+        bar_store_close(&store);
+        return 1;
+      }
+      if (store.date[i] <= prior_date) {
+        printf("\nERROR... Date failed to increase in row %d", i + 1);
+        bar_store_close(&store);
+        return 1;
+      }
+      prior_date = store.date[i];
+    }
+  }
+
+  int ok = 1;
+  if (date != NULL) {
+    *date = NULL;
+    if (store.date == NULL || (*date = (int *) malloc((n > 0 ? n : 1) * sizeof(int))) == NULL)
+      ok = 0;
+    else
+      for (int i = 0; i < n; ++i) (*date)[i] = store.date[i];
+  }
+  for (int k = 0; k < 4; ++k) {
+    if (dst[k] == NULL) continue;
+    *dst[k] = NULL;
+    if (!ok || src[k] == NULL || (*dst[k] = (double *) malloc((n > 0 ? n : 1) * sizeof(double))) == NULL) {
+      ok = 0;
+      continue;
+    }
+    double *out = *dst[k];
+    for (int i = 0; i < n; ++i) {
+      double price = src[k][i];
+      out[i] = (log_prices && price > 0.0) ? log(price) : price;
+    }
+  }
+
+  bar_store_close(&store);
+
+  if (!ok) {
+    if (date != NULL) { free(*date); *date = NULL; }
+    for (int k = 0; k < 4; ++k)
+      if (dst[k] != NULL) { free(*dst[k]); *dst[k] = NULL; }
+    printf("\n\nBar store %s is missing a column or memory is insufficient", filename);
+    return 1;
+  }
+
+  *nrows = n;
+  return 0;
+}
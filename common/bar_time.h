@@ -0,0 +1,43 @@
+// Calendar helpers shared by the bar formats.
+//
+// Bars carry a YYYYMMDD date and, for intraday data, an epoch-millisecond
+// timestamp (UTC). When a file has no timestamps, the timestamp of a bar is
+// taken to be midnight UTC of its date.
+#pragma once
+
+#include <stdint.h>
+
+#define BAR_MS_PER_DAY 86400000LL
+
+// Days since 1970-01-01 for a proleptic Gregorian date (Hinnant's algorithm)
+static inline int64_t bar_days_from_civil(int year, int month, int day) {
+  int64_t y = (int64_t) year - (month <= 2);
+  int64_t era = (y >= 0 ? y : y - 399) / 400;
+  int64_t yoe = y - era * 400;
+  int64_t doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+// Midnight UTC of a YYYYMMDD date, in epoch milliseconds (0 for date 0)
+static inline int64_t bar_date_to_epoch_ms(int yyyymmdd) {
+  if (yyyymmdd == 0) return 0;
+  int year = yyyymmdd / 10000;
+  int month = (yyyymmdd / 100) % 100;
+  int day = yyyymmdd % 100;
+  return bar_days_from_civil(year, month, day) * BAR_MS_PER_DAY;
+}
+
+// UTC calendar date (YYYYMMDD) of an epoch-millisecond timestamp
+static inline int bar_epoch_ms_to_date(int64_t ms) {
+  int64_t z = (ms >= 0 ? ms : ms - (BAR_MS_PER_DAY - 1)) / BAR_MS_PER_DAY + 719468;
+  int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  int64_t doe = z - era * 146097;
+  int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  int64_t mp = (5 * doy + 2) / 153;
+  int day = (int) (doy - (153 * mp + 2) / 5 + 1);
+  int month = (int) (mp < 10 ? mp + 3 : mp - 9);
+  int year = (int) (yoe + era * 400 + (month <= 2));
+  return year * 10000 + month * 100 + day;
+}
@@ -0,0 +1,303 @@
+// Parallel, reproducible bootstrap replications
+//
+// boot_replicate draws nboot bootstrap samples of x and evaluates user_t on
+// each. Sample rep takes its n cases from Philox stream (seed, rep), so
+// params[rep] depends only on the data, the seed and rep. The replications
+// can run on any number of threads and give bit-identical results; callers
+// that sort or count params afterwards get identical confidence bounds.
+//
+// Each worker resamples into its own n-long buffer. user_t is called from
+// several threads at once and must not keep state between calls.
+//
+// boot_jackknife gives the leave-one-out values BCa needs for its
+// acceleration. A statistic that is a function of the additive BootStats
+// alone (mean, profit factor, Sharpe ratio, ...) can supply that function;
+// each value then comes from the totals less one case, O(n) in all, instead
+// of n calls of user_t on n-1 cases.
+//
+// Such statistics can also skip building resamples altogether:
+//   BOOT_WEIGHTS  Each replication draws the same case indices as
+//                 BOOT_RESAMPLE into a per-case count vector, then adds
+//                 each case once, weighted by its count, in case order.
+//                 Only summation order differs from BOOT_RESAMPLE.
+//   BOOT_POISSON  Each case enters each replication w ~ Poisson(1) times
+//                 (Philox stream keyed by the case index), so all nboot
+//                 replications are built in one pass over the data.
+//                 PoissonBoot does this incrementally for data that arrives
+//                 in pieces, keeping only nboot BootStats.
+//
+// A Poisson replication can draw every case zero times (probability e^-n),
+// which leaves no statistic to compute. boot_replicates redraws such
+// replications; PoissonBoot on its own, which no longer has the data, drops
+// them. Statistics never see an empty BootStats.
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parallel.h"
+#include "philox.h"
+
+enum {
+  BOOT_RESAMPLE = 0,   // Copy each resample and call user_t
+  BOOT_WEIGHTS = 1,    // Multinomial case counts into BootStats
+  BOOT_POISSON = 2     // Poisson(1) case counts into BootStats, one pass
+};
+
+#define BOOT_CHUNK 8192   // Cases per pass of the Poisson bootstrap (64 KB of doubles)
+
+// Returns 0 on success, 1 if memory for the worker buffers is insufficient
+static inline int boot_replicate(int n, const double *x, double (*user_t)(int, double *), int nboot,
+                                 uint64_t seed, int nthreads, double *params) {
+  nthreads = parallel_thread_count(nthreads);
+  if (nthreads > nboot) nthreads = nboot;
+  if (nthreads < 1) nthreads = 1;
+
+  double *xwork = (double *) malloc((size_t) nthreads * n * sizeof(double));
+  if (xwork == NULL) return 1;
+
+  parallel_for(nboot, nthreads, [&](int rep, int worker) {
+    double *sample = xwork + (size_t) worker * n;
+    PHILOX_STATE rng;
+    philox_stream(&rng, seed, (uint64_t) rep);
+    for (int i = 0; i < n; i++) {
+      int k = (int) (philox_unifrand(&rng) * n);   // Select a case from the sample
+      if (k >= n)                                   // Only when the draw is exactly 1
+        k = n - 1;
+      sample[i] = x[k];
+    }
+    params[rep] = user_t(n, sample);
+  });
+
+  free(xwork);
+  return 0;
+}
+
+// Additive sufficient statistics of a set of cases
+typedef struct {
+  double sum;        // Sum of cases
+  double sum_sq;     // Sum of squared cases
+  double win_sum;    // Sum of positive cases
+  double lose_sum;   // Minus the sum of the other cases
+  int n;             // Number of cases
+} BootStats;
+
+static inline void boot_stats_clear(BootStats *s) {
+  s->sum = s->sum_sq = s->win_sum = s->lose_sum = 0.0;
+  s->n = 0;
+}
+
+// The win/lose split adds an exact 0 to the other side instead of
+// branching on the sign, which is unpredictable for trade returns
+static inline void boot_stats_add(BootStats *s, double x) {
+  double win = x > 0.0 ? x : 0.0;
+  s->sum += x;
+  s->sum_sq += x * x;
+  s->win_sum += win;
+  s->lose_sum -= x - win;
+  ++s->n;
+}
+
+// Add x w times (w may be 0)
+static inline void boot_stats_add_weighted(BootStats *s, double x, int w) {
+  double wx = w * x;
+  double win = wx > 0.0 ? wx : 0.0;
+  s->sum += wx;
+  s->sum_sq += wx * x;
+  s->win_sum += win;
+  s->lose_sum -= wx - win;
+  s->n += w;
+}
+
+static inline void boot_stats_remove(BootStats *s, double x) {
+  double win = x > 0.0 ? x : 0.0;
+  s->sum -= x;
+  s->sum_sq -= x * x;
+  s->win_sum -= win;
+  s->lose_sum += x - win;
+  --s->n;
+}
+
+// jack[i] = statistic of x without case i. user_stats computes the statistic
+// from BootStats; if it is NULL, user_t is called on n-1 cases for each i,
+// with case i swapped for the last (x is restored afterwards).
+static inline void boot_jackknife(int n, double *x, double (*user_t)(int, double *),
+                                  double (*user_stats)(const BootStats *), double *jack) {
+  if (user_stats != NULL) {
+    BootStats all, loo;
+    boot_stats_clear(&all);
+    for (int i = 0; i < n; i++) boot_stats_add(&all, x[i]);
+    for (int i = 0; i < n; i++) {
+      loo = all;
+      boot_stats_remove(&loo, x[i]);
+      jack[i] = user_stats(&loo);
+    }
+    return;
+  }
+
+  double xlast = x[n - 1];
+  for (int i = 0; i < n; i++) {
+    double xtemp = x[i];   // Preserve case being temporarily removed
+    x[i] = xlast;          // Swap in last case
+    jack[i] = user_t(n - 1, x);
+    x[i] = xtemp;          // Restore original case
+  }
+}
+
+// BOOT_WEIGHTS: params[rep] = user_stats of the cases drawn for rep.
+// The draws only touch an n-long count vector per worker; the cases are
+// then read once, in order, as count * value.
+// Returns 0 on success, 1 if memory for the count vectors is insufficient
+static inline int boot_replicate_weights(int n, const double *x, double (*user_stats)(const BootStats *),
+                                         int nboot, uint64_t seed, int nthreads, double *params) {
+  nthreads = parallel_thread_count(nthreads);
+  if (nthreads > nboot) nthreads = nboot;
+  if (nthreads < 1) nthreads = 1;
+
+  int *counts = (int *) malloc((size_t) nthreads * n * sizeof(int));
+  if (counts == NULL) return 1;
+
+  parallel_for(nboot, nthreads, [&](int rep, int worker) {
+    int *count = counts + (size_t) worker * n;
+    PHILOX_STATE rng;
+    BootStats stats;
+    memset(count, 0, (size_t) n * sizeof(int));
+    philox_stream(&rng, seed, (uint64_t) rep);
+    for (int i = 0; i < n; i++) {
+      int k = (int) (philox_unifrand(&rng) * n);
+      if (k >= n)
+        k = n - 1;
+      ++count[k];
+    }
+    boot_stats_clear(&stats);
+    for (int i = 0; i < n; i++) boot_stats_add_weighted(&stats, x[i], count[i]);
+    params[rep] = user_stats(&stats);
+  });
+
+  free(counts);
+  return 0;
+}
+
+// Streaming Poisson bootstrap. Case i (counted over every call of
+// poisson_boot_add) enters replications 4g .. 4g+3 the number of times
+// given by the four words of Philox block (i, g, 0) of the seed, so the
+// result does not depend on how the data is split into calls or on the
+// thread count. Redraw a of an empty replication uses blocks (i, g, a).
+typedef struct {
+  int nboot;
+  uint64_t seed;
+  long long ncases;        // Cases added so far
+  uint32_t cdf[12];        // 2^32 * P(Poisson(1) <= k)
+  BootStats *stats;        // Nboot; totals of each replication
+} PoissonBoot;
+
+// Returns 0 on success, 1 if memory is insufficient
+static inline int poisson_boot_init(PoissonBoot *pb, int nboot, uint64_t seed) {
+  pb->nboot = nboot;
+  pb->seed = seed;
+  pb->ncases = 0;
+  double p = exp(-1.0), cum = 0.0;
+  for (int k = 0; k < 12; k++) {
+    cum += p;
+    p /= k + 1;
+    double t = cum * 4294967296.0;
+    pb->cdf[k] = t >= 4294967295.0 ? 0xFFFFFFFFu : (uint32_t) t;
+  }
+  pb->stats = (BootStats *) malloc((size_t) nboot * sizeof(BootStats));
+  if (pb->stats == NULL) return 1;
+  for (int b = 0; b < nboot; b++) boot_stats_clear(pb->stats + b);
+  return 0;
+}
+
+// Poisson(1) count for uniform 32-bit word u: inverse CDF, without
+// data-dependent branches
+static inline int poisson_boot_weight(const PoissonBoot *pb, uint32_t u) {
+  int w = 0;
+  for (int k = 0; k < 12; k++) w += u >= pb->cdf[k];
+  return w;
+}
+
+static inline void poisson_boot_free(PoissonBoot *pb) {
+  free(pb->stats);
+  pb->stats = NULL;
+}
+
+// Add n more cases. Groups of four replications are shared out among
+// threads; each group reads the cases one BOOT_CHUNK at a time.
+static inline void poisson_boot_add(PoissonBoot *pb, int n, const double *x, int nthreads) {
+  int ngroups = (pb->nboot + 3) / 4;
+  for (int start = 0; start < n; start += BOOT_CHUNK) {
+    int stop = start + BOOT_CHUNK < n ? start + BOOT_CHUNK : n;
+    long long first = pb->ncases + start;
+    parallel_for(ngroups, nthreads, [&](int g, int) {
+      uint32_t key[2] = {(uint32_t) pb->seed, (uint32_t) (pb->seed >> 32)};
+      uint32_t ctr[4], w32[4];
+      int nrep = pb->nboot - 4 * g < 4 ? pb->nboot - 4 * g : 4;
+      BootStats *stats = pb->stats + 4 * g;
+      ctr[2] = (uint32_t) g;
+      ctr[3] = 0;
+      for (int i = start; i < stop; i++) {
+        uint64_t icase = (uint64_t) (first + i - start);
+        ctr[0] = (uint32_t) icase;
+        ctr[1] = (uint32_t) (icase >> 32);
+        philox4x32_10(ctr, key, w32);
+        for (int r = 0; r < nrep; r++) boot_stats_add_weighted(stats + r, x[i], poisson_boot_weight(pb, w32[r]));
+      }
+    });
+  }
+  pb->ncases += n;
+}
+
+// Redraw every replication that came out empty, given all pb->ncases cases
+// again in x. Needs at least one case.
+static inline void poisson_boot_redraw_empty(PoissonBoot *pb, const double *x) {
+  uint32_t key[2] = {(uint32_t) pb->seed, (uint32_t) (pb->seed >> 32)};
+  uint32_t ctr[4], w32[4];
+  if (pb->ncases < 1) return;
+  for (int b = 0; b < pb->nboot; b++) {
+    BootStats *stats = pb->stats + b;   // All zero while it is empty
+    ctr[2] = (uint32_t) (b / 4);
+    for (uint32_t attempt = 1; stats->n == 0; attempt++) {
+      ctr[3] = attempt;
+      for (long long i = 0; i < pb->ncases; i++) {
+        ctr[0] = (uint32_t) i;
+        ctr[1] = (uint32_t) ((uint64_t) i >> 32);
+        philox4x32_10(ctr, key, w32);
+        boot_stats_add_weighted(stats, x[i], poisson_boot_weight(pb, w32[b % 4]));
+      }
+    }
+  }
+}
+
+// Statistic of each non-empty replication, packed into params.
+// Returns how many were written (nboot unless some were empty).
+static inline int poisson_boot_params(const PoissonBoot *pb, double (*user_stats)(const BootStats *), double *params) {
+  int nout = 0;
+  for (int b = 0; b < pb->nboot; b++) {
+    if (pb->stats[b].n > 0) params[nout++] = user_stats(pb->stats + b);
+  }
+  return nout;
+}
+
+// Nboot bootstrap values of a statistic by any of the methods above.
+// BOOT_WEIGHTS and BOOT_POISSON need user_stats and fall back to
+// BOOT_RESAMPLE without it. Returns 0 on success, 1 if memory is insufficient.
+static inline int boot_replicates(int n, const double *x, double (*user_t)(int, double *),
+                                  double (*user_stats)(const BootStats *), int method, int nboot,
+                                  uint64_t seed, int nthreads, double *params) {
+  if (user_stats == NULL || method == BOOT_RESAMPLE)
+    return boot_replicate(n, x, user_t, nboot, seed, nthreads, params);
+
+  if (method == BOOT_WEIGHTS)
+    return boot_replicate_weights(n, x, user_stats, nboot, seed, nthreads, params);
+
+  PoissonBoot pb;
+  if (poisson_boot_init(&pb, nboot, seed)) return 1;
+  poisson_boot_add(&pb, n, x, nthreads);
+  poisson_boot_redraw_empty(&pb, x);   // So every replication has a value
+  poisson_boot_params(&pb, user_stats, params);
+  poisson_boot_free(&pb);
+  return 0;
+}
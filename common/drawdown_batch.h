@@ -0,0 +1,59 @@
+// Batched drawdown kernel
+//
+// DRAWDOWN and CHOOSER_DD find drawdown quantiles by evaluating the maximum
+// drawdown of many bootstrap trade sequences. The scalar loop is a serial
+// chain (cumulative sum, running max, largest loss) with a data-dependent
+// branch, so one sequence at a time leaves most of the core idle.
+//
+// drawdown_batch runs DD_BATCH sequences side by side. They are stored
+// interleaved (structure of arrays), trade i of sequence b at
+// sample[i * DD_BATCH + b], so each step loads one row and updates every
+// sequence's cumulative sum, running max and drawdown in vector registers.
+// The branch becomes
+//   max_price = max(max_price, cumulative);  dd = max(dd, max_price - cumulative)
+// which does the same operations on the same values as the scalar loop (a
+// new high gives a loss of exactly 0, and dd >= 0), so every drawdown
+// matches it bit for bit.
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DD_BATCH_SSE2 1
+#endif
+
+#define DD_BATCH 8   // Sequences per call; four SSE2 registers per quantity
+
+// dd[b] = maximum drawdown of sequence b (in the units of the trades)
+static inline void drawdown_batch(int n, const double *sample, double *dd) {
+#ifdef DD_BATCH_SSE2
+  __m128d cum[DD_BATCH / 2], max_price[DD_BATCH / 2], loss[DD_BATCH / 2];
+  for (int j = 0; j < DD_BATCH / 2; j++) {
+    cum[j] = max_price[j] = _mm_loadu_pd(sample + 2 * j);
+    loss[j] = _mm_setzero_pd();
+  }
+  for (int i = 1; i < n; i++) {
+    const double *row = sample + (size_t) i * DD_BATCH;
+    for (int j = 0; j < DD_BATCH / 2; j++) {
+      cum[j] = _mm_add_pd(cum[j], _mm_loadu_pd(row + 2 * j));
+      max_price[j] = _mm_max_pd(cum[j], max_price[j]);   // Ties keep the old value, as the branch does
+      loss[j] = _mm_max_pd(_mm_sub_pd(max_price[j], cum[j]), loss[j]);
+    }
+  }
+  for (int j = 0; j < DD_BATCH / 2; j++) _mm_storeu_pd(dd + 2 * j, loss[j]);
+#else
+  double cum[DD_BATCH], max_price[DD_BATCH];
+  for (int b = 0; b < DD_BATCH; b++) {
+    cum[b] = max_price[b] = sample[b];
+    dd[b] = 0.0;
+  }
+  for (int i = 1; i < n; i++) {
+    const double *row = sample + (size_t) i * DD_BATCH;
+    for (int b = 0; b < DD_BATCH; b++) {
+      cum[b] += row[b];
+      if (cum[b] > max_price[b]) max_price[b] = cum[b];
+      double loss = max_price[b] - cum[b];
+      if (loss > dd[b]) dd[b] = loss;
+    }
+  }
+#endif
+}
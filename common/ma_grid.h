@@ -0,0 +1,341 @@
+// Moving-average crossover grid kernel
+//
+// MCPT_TRN, SELBIAS, TRNBIAS, BND_RET and CSCV_MKT all evaluate a primitive
+// moving-average crossover system (long when the short-term MA of log prices
+// is above the long-term MA, short when below) for every pair of lookbacks
+// 1 <= ishort < ilong <= max_lookback. Each used to do it one pair at a time
+// with its own copy of the loop: two divisions per pair per bar.
+//
+// This kernel evaluates every pair over a block of bars at once:
+//   - The rolling long-term sum of a pair depends only on ilong (the old
+//     loops summed the same prices in the same order for every ishort), so
+//     each long-term mean is computed once per bar, not once per pair.
+//   - When every pair starts at the same decision bar, the short-term sum
+//     depends only on ishort, so the short-term means are shared as well and
+//     the per-pair work is a compare and a few adds, two pairs per SSE2
+//     instruction.
+//   - When each ilong starts at its own bar ilong-1 (`staggered`), the short
+//     sums are kept per pair, as the old loops had them.
+// Every pair sees the same floating-point operations in the same order as
+// the old per-pair loop, so all totals and positions match it bit for bit.
+//
+// Pairs are numbered as the old loops visited them, ilong outer, ishort inner:
+//   ma_grid_pair(ishort, ilong) = (ilong-1)*(ilong-2)/2 + ishort-1
+//
+//   MaGrid grid;
+//   ma_grid_alloc(&grid, max_lookback, 0);
+//   ma_grid_start(&grid, x, max_lookback-1, MA_GRID_LONG_SHORT, 0.0);
+//   ma_grid_run(&grid, x, ncases-1, (double *) NULL, 0);
+//   ... grid.total[ma_grid_pair(ishort, ilong)] ...
+//   ma_grid_free(&grid);
+//
+// The decision at bar i uses MAs ending at bar i and earns x[i+1] - x[i]
+// (negated when short). ma_grid_run may be called repeatedly with increasing
+// last bars to walk the history in pieces, optionally collecting per-bar
+// returns of every pair.
+#pragma once
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MA_GRID_SSE2 1
+#endif
+
+#define MA_GRID_BLOCK 32   // Bars whose means are computed before pairs are scored
+
+enum {
+  MA_GRID_LONG_SHORT = 0,   // Long above, short below
+  MA_GRID_LONG_ONLY = 1,    // Long above, out below
+  MA_GRID_SHORT_ONLY = 2    // Short below, out above
+};
+
+typedef struct {
+  int max_lookback;   // Long-term lookbacks 2 .. max_lookback
+  int npairs;         // max_lookback * (max_lookback-1) / 2
+  int staggered;      // Each ilong starts at bar ilong-1, else all start at first_bar
+  int first_bar;      // First decision bar (unstaggered)
+  int next_bar;       // Next decision bar ma_grid_run will evaluate
+  int mode;           // MA_GRID_LONG_SHORT, _LONG_ONLY or _SHORT_ONLY
+  int min_long;       // Long-term lookbacks scored by ma_grid_run; alloc sets
+  int max_long;       // 2 and max_lookback, and a caller may narrow them
+
+  // Per pair, indexed by ma_grid_pair(ishort, ilong)
+  double *total;      // Sum of returns
+  double *sum_sq;     // Sum of squared returns
+  double *win_sum;    // Sum of positive returns
+  double *lose_sum;   // Minus the sum of the other returns
+  double *n_long;     // Bars long
+  double *n_short;    // Bars short
+
+  // Work areas
+  double *short_sum;  // Rolling short-term sums: per ishort, or per pair if staggered
+  double *long_sum;   // Rolling long-term sums, per ilong (index ilong-2)
+  double *short_mean; // MA_GRID_BLOCK bars by max_lookback-1 short-term means
+  double *long_mean;  // MA_GRID_BLOCK bars by max_lookback-1 long-term means
+  double *up;         // MA_GRID_BLOCK returns of a long position
+  double *down;       // MA_GRID_BLOCK returns of a short position
+  double *lookback;   // 1, 2, ..., max_lookback as doubles
+  double *block;      // One allocation holding all of the above
+} MaGrid;
+
+static inline int ma_grid_pair(int ishort, int ilong) {
+  return (ilong - 1) * (ilong - 2) / 2 + ishort - 1;
+}
+
+// Returns 0 on success, 1 if memory is insufficient
+static inline int ma_grid_alloc(MaGrid *grid, int max_lookback, int staggered) {
+  memset(grid, 0, sizeof(*grid));
+  if (max_lookback < 2) max_lookback = 2;
+  size_t nlook = (size_t) max_lookback - 1;
+  size_t npairs = (size_t) max_lookback * (max_lookback - 1) / 2;
+  size_t nshort = staggered ? npairs : nlook;
+  size_t n = 6 * npairs + nshort + nlook + 2 * MA_GRID_BLOCK * nlook + 2 * MA_GRID_BLOCK + nlook + 1;
+  grid->block = (double *) malloc(n * sizeof(double));
+  if (grid->block == NULL) return 1;
+
+  grid->max_lookback = max_lookback;
+  grid->min_long = 2;
+  grid->max_long = max_lookback;
+  grid->npairs = (int) npairs;
+  grid->staggered = staggered;
+  double *p = grid->block;
+  grid->total = p; p += npairs;
+  grid->sum_sq = p; p += npairs;
+  grid->win_sum = p; p += npairs;
+  grid->lose_sum = p; p += npairs;
+  grid->n_long = p; p += npairs;
+  grid->n_short = p; p += npairs;
+  grid->short_sum = p; p += nshort;
+  grid->long_sum = p; p += nlook;
+  grid->short_mean = p; p += MA_GRID_BLOCK * nlook;
+  grid->long_mean = p; p += MA_GRID_BLOCK * nlook;
+  grid->up = p; p += MA_GRID_BLOCK;
+  grid->down = p; p += MA_GRID_BLOCK;
+  grid->lookback = p;
+  for (size_t k = 0; k <= nlook; k++) grid->lookback[k] = (double) (k + 1);
+  return 0;
+}
+
+static inline void ma_grid_free(MaGrid *grid) {
+  free(grid->block);
+  memset(grid, 0, sizeof(*grid));
+}
+
+// Sums for the first decision bar f of long lookback ilong, accumulated in
+// the order of the old loops: 0 + x[f] + x[f-1] + ...; the short sum of
+// ishort is the chain after ishort terms and the long sum after ilong.
+static inline void ma_grid_first_sums(const double *x, int f, int ilong, double *short_sum, double *long_sum) {
+  double sum = 0.0;
+  for (int k = 0; k < ilong; k++) {
+    sum += x[f - k];
+    if (k < ilong - 1 && short_sum != NULL) short_sum[k] = sum;
+  }
+  *long_sum = sum;
+}
+
+// Start a pass at decision bar first_bar (>= max_lookback-1; ignored if
+// staggered). win_sum, lose_sum and sum_sq start at `tiny` (some programs
+// use 1.e-60 to keep ratios finite); the other totals start at 0.
+static inline void ma_grid_start(MaGrid *grid, const double *x, int first_bar, int mode, double tiny) {
+  int max_lookback = grid->max_lookback;
+  grid->mode = mode;
+
+  if (grid->staggered) {
+    grid->first_bar = 1;   // Bar of ilong = 2
+    for (int ilong = 2; ilong <= max_lookback; ilong++)
+      ma_grid_first_sums(x, ilong - 1, ilong, grid->short_sum + ma_grid_pair(1, ilong), grid->long_sum + ilong - 2);
+  }
+  else {
+    grid->first_bar = first_bar;
+    ma_grid_first_sums(x, first_bar, max_lookback, grid->short_sum, grid->long_sum + max_lookback - 2);
+    double sum = 0.0;   // The same chain gives every shorter long-term sum
+    for (int k = 0; k < max_lookback - 1; k++) {
+      sum += x[first_bar - k];
+      if (k >= 1) grid->long_sum[k - 1] = sum;
+    }
+  }
+  grid->next_bar = grid->first_bar;
+
+  for (int p = 0; p < grid->npairs; p++) {
+    grid->total[p] = grid->n_long[p] = grid->n_short[p] = 0.0;
+    grid->sum_sq[p] = grid->win_sum[p] = grid->lose_sum[p] = tiny;
+  }
+}
+
+// sum[k] += xi - x[back - k] for k < n, then mean[k] = sum[k] / divisor[k]
+static inline void ma_grid_roll(double *sum, double *mean, const double *divisor, int n, int update,
+                                double xi, const double *x, int back) {
+  int k = 0;
+#ifdef MA_GRID_SSE2
+  const __m128d v_xi = _mm_set1_pd(xi);
+  for (; k + 2 <= n; k += 2) {
+    __m128d s = _mm_loadu_pd(sum + k);
+    if (update) {
+      __m128d old = _mm_loadu_pd(x + back - k - 1);   // x[back-k-1], x[back-k]
+      old = _mm_shuffle_pd(old, old, 1);
+      s = _mm_add_pd(s, _mm_sub_pd(v_xi, old));
+      _mm_storeu_pd(sum + k, s);
+    }
+    _mm_storeu_pd(mean + k, _mm_div_pd(s, _mm_loadu_pd(divisor + k)));
+  }
+#endif
+  for (; k < n; k++) {
+    if (update) sum[k] += xi - x[back - k];
+    mean[k] = sum[k] / divisor[k];
+  }
+}
+
+// Score pairs p0 .. p0+n-1 (ishort = 1 .. n of one ilong) over nbars bars.
+// At bar t pair p0+k compares short_mean[t * mean_stride + k] with
+// long_mean[t * long_stride] and earns up[t] or down[t], which is stored in
+// rets[k * stride + t] if rets is not NULL. Each pair's totals stay in
+// registers for all the bars, which are still added in bar order.
+template <class Real>
+static inline void ma_grid_score(MaGrid *grid, int p0, int n, int nbars,
+                                 const double *short_mean, size_t mean_stride,
+                                 const double *long_mean, size_t long_stride,
+                                 const double *up, const double *down, Real *rets, size_t stride) {
+  const int use_long = grid->mode != MA_GRID_SHORT_ONLY;
+  const int use_short = grid->mode != MA_GRID_LONG_ONLY;
+  int k = 0;
+
+#ifdef MA_GRID_SSE2
+  const __m128d v_one = _mm_set1_pd(1.0);
+  const __m128d v_zero = _mm_setzero_pd();
+  const __m128d long_mask = _mm_castsi128_pd(_mm_set1_epi32(use_long ? -1 : 0));
+  const __m128d short_mask = _mm_castsi128_pd(_mm_set1_epi32(use_short ? -1 : 0));
+
+  for (; k + 2 <= n; k += 2) {
+    int p = p0 + k;
+    __m128d total = _mm_loadu_pd(grid->total + p);
+    __m128d sum_sq = _mm_loadu_pd(grid->sum_sq + p);
+    __m128d win_sum = _mm_loadu_pd(grid->win_sum + p);
+    __m128d lose_sum = _mm_loadu_pd(grid->lose_sum + p);
+    __m128d n_long = _mm_loadu_pd(grid->n_long + p);
+    __m128d n_short = _mm_loadu_pd(grid->n_short + p);
+
+    for (int t = 0; t < nbars; t++) {
+      __m128d sm = _mm_loadu_pd(short_mean + t * mean_stride + k);
+      __m128d lm = _mm_set1_pd(long_mean[t * long_stride]);
+      __m128d is_long = _mm_and_pd(_mm_cmpgt_pd(sm, lm), long_mask);
+      __m128d is_short = _mm_and_pd(_mm_cmplt_pd(sm, lm), short_mask);
+      __m128d ret = _mm_or_pd(_mm_and_pd(is_long, _mm_set1_pd(up[t])), _mm_and_pd(is_short, _mm_set1_pd(down[t])));
+      __m128d is_win = _mm_cmpgt_pd(ret, v_zero);
+
+      total = _mm_add_pd(total, ret);
+      sum_sq = _mm_add_pd(sum_sq, _mm_mul_pd(ret, ret));
+      win_sum = _mm_add_pd(win_sum, _mm_and_pd(is_win, ret));
+      lose_sum = _mm_sub_pd(lose_sum, _mm_andnot_pd(is_win, ret));
+      n_long = _mm_add_pd(n_long, _mm_and_pd(is_long, v_one));
+      n_short = _mm_add_pd(n_short, _mm_and_pd(is_short, v_one));
+      if (rets != NULL) {
+        double r[2];
+        _mm_storeu_pd(r, ret);
+        rets[(size_t) k * stride + t] = (Real) r[0];
+        rets[(size_t) (k + 1) * stride + t] = (Real) r[1];
+      }
+    }
+
+    _mm_storeu_pd(grid->total + p, total);
+    _mm_storeu_pd(grid->sum_sq + p, sum_sq);
+    _mm_storeu_pd(grid->win_sum + p, win_sum);
+    _mm_storeu_pd(grid->lose_sum + p, lose_sum);
+    _mm_storeu_pd(grid->n_long + p, n_long);
+    _mm_storeu_pd(grid->n_short + p, n_short);
+  }
+#endif
+
+  for (; k < n; k++) {
+    int p = p0 + k;
+    double total = grid->total[p], sum_sq = grid->sum_sq[p];
+    double win_sum = grid->win_sum[p], lose_sum = grid->lose_sum[p];
+    double n_long = grid->n_long[p], n_short = grid->n_short[p];
+
+    for (int t = 0; t < nbars; t++) {
+      double sm = short_mean[t * mean_stride + k], lm = long_mean[t * long_stride];
+      double ret = 0.0;
+      if (use_long && sm > lm) {
+        ret = up[t];
+        n_long += 1.0;
+      }
+      else if (use_short && sm < lm) {
+        ret = down[t];
+        n_short += 1.0;
+      }
+      total += ret;
+      sum_sq += ret * ret;
+      if (ret > 0.0)
+        win_sum += ret;
+      else
+        lose_sum -= ret;
+      if (rets != NULL)
+        rets[(size_t) k * stride + t] = (Real) ret;
+    }
+
+    grid->total[p] = total;
+    grid->sum_sq[p] = sum_sq;
+    grid->win_sum[p] = win_sum;
+    grid->lose_sum[p] = lose_sum;
+    grid->n_long[p] = n_long;
+    grid->n_short[p] = n_short;
+  }
+}
+
+// Evaluate decision bars next_bar .. last_bar-1 (last_bar <= ncases-1) for
+// long-term lookbacks min_long .. max_long. If rets is not NULL, the return
+// of pair p at bar i goes to rets[(p - p_min) * stride + i - next_bar], where
+// p_min = ma_grid_pair(1, min_long), for bars at or after the pair's start.
+template <class Real>
+static inline void ma_grid_run(MaGrid *grid, const double *x, int last_bar, Real *rets, size_t stride) {
+  const int max_lookback = grid->max_lookback;
+  const size_t nlook = (size_t) max_lookback - 1;
+  const int base_bar = grid->next_bar;
+  const size_t p_min = (size_t) ma_grid_pair(1, grid->min_long);
+
+  for (int b0 = grid->next_bar; b0 < last_bar; b0 += MA_GRID_BLOCK) {
+    int b1 = b0 + MA_GRID_BLOCK < last_bar ? b0 + MA_GRID_BLOCK : last_bar;
+    Real *block_rets = rets != NULL ? rets + (b0 - base_bar) : rets;
+
+    for (int i = b0; i < b1; i++) {
+      grid->up[i - b0] = x[i + 1] - x[i];
+      grid->down[i - b0] = x[i] - x[i + 1];
+    }
+
+    if (! grid->staggered) {
+      // Means of every lookback at every bar of the block, then every pair
+      for (int i = b0; i < b1; i++) {
+        int t = i - b0, update = i > grid->first_bar;
+        ma_grid_roll(grid->short_sum, grid->short_mean + t * nlook, grid->lookback, (int) nlook, update, x[i], x, i - 1);
+        ma_grid_roll(grid->long_sum, grid->long_mean + t * nlook, grid->lookback + 1, (int) nlook, update, x[i], x, i - 2);
+      }
+      for (int ilong = grid->min_long; ilong <= grid->max_long; ilong++) {
+        int p0 = ma_grid_pair(1, ilong);
+        ma_grid_score(grid, p0, ilong - 1, b1 - b0, grid->short_mean, nlook, grid->long_mean + ilong - 2, nlook,
+                      grid->up, grid->down, block_rets != NULL ? block_rets + (p0 - p_min) * stride : block_rets, stride);
+      }
+    }
+
+    else {
+      for (int ilong = grid->min_long; ilong <= grid->max_long; ilong++) {
+        int p0 = ma_grid_pair(1, ilong), f = ilong - 1;
+        int i0 = b0 > f ? b0 : f;
+        if (i0 >= b1) continue;
+        double *long_sum = grid->long_sum + ilong - 2;
+        for (int i = i0; i < b1; i++) {
+          int t = i - i0, update = i > f;
+          if (update) *long_sum += x[i] - x[i - ilong];
+          grid->long_mean[t] = *long_sum / ilong;
+          ma_grid_roll(grid->short_sum + p0, grid->short_mean + t * nlook, grid->lookback, ilong - 1, update, x[i], x, i - 1);
+        }
+        ma_grid_score(grid, p0, ilong - 1, b1 - i0, grid->short_mean, nlook, grid->long_mean, 1,
+                      grid->up + (i0 - b0), grid->down + (i0 - b0),
+                      block_rets != NULL ? block_rets + (p0 - p_min) * stride + (i0 - b0) : block_rets, stride);
+      }
+    }
+  }
+
+  if (last_bar > grid->next_bar)
+    grid->next_bar = last_bar;
+}
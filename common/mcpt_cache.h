@@ -0,0 +1,179 @@
+// Resumable per-replication results for the MCPT programs
+//
+// Each MCPT replication shuffles with its own random stream derived from the
+// seed and the replication number (see rand32m.h), so replication k of a run
+// is the same no matter how many replications the run asks for. A cache file
+// keeps the outputs of every replication computed so far; a later run with a
+// larger nreps reads them back and computes only the missing ones.
+//
+// Layout (host byte order):
+//   McptCacheHeader                 fixed size, starts with MCPT_CACHE_MAGIC
+//   McptCacheRec[header.nrecs]      replication 0 (unpermuted) first
+//
+// The header doubles as the cache key: program name, a content hash of the
+// market file, the lookback and the seed must all match or the cache is
+// ignored. New replications are appended and the record count in the header
+// is updated last, so an interrupted write leaves the earlier records valid.
+#pragma once
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <sys/types.h>   // off_t for fseeko
+#endif
+
+#include "bar_store.h"   // bar_store_fnv1a
+
+#define MCPT_CACHE_MAGIC "MCPTREP"   // 7 chars + NUL fill the 8-byte magic
+#define MCPT_CACHE_VERSION 1
+
+typedef struct {
+  double opt_return;        // Best in-sample return of this replication
+  double param1;            // Optimal parameters (program specific)
+  double param2;
+  double trend_component;   // Part of opt_return due to the trend
+  int32_t nlong;
+  int32_t nshort;
+} McptCacheRec;
+
+typedef struct {
+  char magic[8];
+  uint32_t version;
+  uint32_t rec_bytes;
+  char program[16];
+  uint64_t file_hash;       // Content hash of the market file
+  int32_t lookback;
+  uint32_t seed;
+  uint64_t nrecs;
+} McptCacheHeader;
+
+enum {
+  MCPT_CACHE_OK = 0,        // Loaded (possibly zero records: no file yet)
+  MCPT_CACHE_ERROR = 1,     // Unreadable or damaged; errmsg says why
+  MCPT_CACHE_MISMATCH = 2   // Written for other data, lookback or seed
+};
+
+// Seek to a 64-bit offset; long is only 32 bits on Windows, and the records
+// pass 2 GiB long before nrecs reaches INT_MAX
+static inline int mcpt_cache_seek(FILE *fp, uint64_t offset) {
+#if defined(_WIN32)
+  return _fseeki64(fp, (__int64) offset, SEEK_SET);
+#else
+  return fseeko(fp, (off_t) offset, SEEK_SET);
+#endif
+}
+
+// FNV-1a 64 over the bytes of a file. Returns 0 on success, 1 if unreadable.
+static inline int mcpt_file_hash(const char *filename, uint64_t *hash) {
+  FILE *fp = fopen(filename, "rb");
+  if (fp == NULL) return 1;
+  size_t size = 1 << 20;   // A multiple of 8, so only the final block can be partial
+  unsigned char *buf = (unsigned char *) malloc(size);
+  if (buf == NULL) { fclose(fp); return 1; }
+  uint64_t h = BAR_STORE_FNV_OFFSET;
+  size_t got;
+  while ((got = fread(buf, 1, size, fp)) > 0)
+    h = bar_store_fnv1a(h, buf, got);
+  int bad = ferror(fp);
+  free(buf);
+  fclose(fp);
+  *hash = h;
+  return bad ? 1 : 0;
+}
+
+static inline void mcpt_cache_key(McptCacheHeader *key, const char *program, uint64_t file_hash,
+                                  int lookback, unsigned int seed) {
+  memset(key, 0, sizeof(*key));
+  memcpy(key->magic, MCPT_CACHE_MAGIC, sizeof(key->magic));
+  key->version = MCPT_CACHE_VERSION;
+  key->rec_bytes = sizeof(McptCacheRec);
+  strncpy(key->program, program, sizeof(key->program) - 1);
+  key->file_hash = file_hash;
+  key->lookback = lookback;
+  key->seed = seed;
+}
+
+// Read the records of `cachefile` if its header matches `key`.
+// *recs is malloc'd (release with free()) and NULL when *nrecs is 0.
+static inline int mcpt_cache_load(const char *cachefile, const McptCacheHeader *key,
+                                  McptCacheRec **recs, int *nrecs, char *errmsg, size_t errlen) {
+  McptCacheHeader hdr;
+  *recs = NULL;
+  *nrecs = 0;
+
+  FILE *fp = fopen(cachefile, "rb");
+  if (fp == NULL) return MCPT_CACHE_OK;   // No cache yet
+
+  if (fread(&hdr, sizeof(hdr), 1, fp) != 1 || memcmp(hdr.magic, MCPT_CACHE_MAGIC, sizeof(hdr.magic))
+   || hdr.version != MCPT_CACHE_VERSION || hdr.rec_bytes != sizeof(McptCacheRec) || hdr.nrecs > INT_MAX) {
+    fclose(fp);
+    snprintf(errmsg, errlen, "%s is not an MCPT cache file of this version", cachefile);
+    return MCPT_CACHE_ERROR;
+  }
+
+  hdr.nrecs = 0;   // Compare everything but the count
+  if (memcmp(&hdr, key, sizeof(hdr))) {
+    fclose(fp);
+    snprintf(errmsg, errlen, "%s was written for a different market file, lookback, seed or program", cachefile);
+    return MCPT_CACHE_MISMATCH;
+  }
+
+  if (mcpt_cache_seek(fp, 0) != 0 || fread(&hdr, sizeof(hdr), 1, fp) != 1) {
+    fclose(fp);
+    snprintf(errmsg, errlen, "Error reading %s", cachefile);
+    return MCPT_CACHE_ERROR;
+  }
+
+  if (hdr.nrecs > 0) {
+    *recs = (McptCacheRec *) malloc((size_t) hdr.nrecs * sizeof(McptCacheRec));
+    if (*recs == NULL || fread(*recs, sizeof(McptCacheRec), (size_t) hdr.nrecs, fp) != (size_t) hdr.nrecs) {
+      free(*recs);
+      *recs = NULL;
+      fclose(fp);
+      snprintf(errmsg, errlen, "%s is truncated or memory is insufficient", cachefile);
+      return MCPT_CACHE_ERROR;
+    }
+  }
+
+  fclose(fp);
+  *nrecs = (int) hdr.nrecs;
+  return MCPT_CACHE_OK;
+}
+
+// Store recs[nold..nnew) after the nold records already in the file, which
+// must have been loaded with the same key. With nold = 0 the file is created
+// (or replaced). Returns 0 on success; otherwise writes errmsg and returns 1.
+static inline int mcpt_cache_append(const char *cachefile, const McptCacheHeader *key,
+                                    const McptCacheRec *recs, int nold, int nnew,
+                                    char *errmsg, size_t errlen) {
+  McptCacheHeader hdr = *key;
+  FILE *fp = fopen(cachefile, (nold > 0) ? "r+b" : "wb");
+  if (fp == NULL) {
+    snprintf(errmsg, errlen, "Cannot open MCPT cache %s for writing", cachefile);
+    return 1;
+  }
+
+  hdr.nrecs = (uint64_t) nold;
+  int ok = 1;
+  if (nold == 0)
+    ok = fwrite(&hdr, sizeof(hdr), 1, fp) == 1;
+
+  ok = ok && mcpt_cache_seek(fp, (uint64_t) sizeof(hdr) + (uint64_t) nold * sizeof(McptCacheRec)) == 0
+          && fwrite(recs + nold, sizeof(McptCacheRec), (size_t) (nnew - nold), fp) == (size_t) (nnew - nold)
+          && fflush(fp) == 0;
+
+  // Publish the new records only once they are written
+  hdr.nrecs = (uint64_t) nnew;
+  ok = ok && mcpt_cache_seek(fp, 0) == 0 && fwrite(&hdr, sizeof(hdr), 1, fp) == 1;
+
+  if (fclose(fp) != 0) ok = 0;
+  if (!ok) {
+    snprintf(errmsg, errlen, "Error writing MCPT cache %s", cachefile);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,48 @@
+// Sequential early stopping for Monte-Carlo permutation tests
+//
+// An MCPT p-value is count/n, where count includes the unpermuted run. When
+// only the decision "p <= alpha or not" matters, most of the replications of
+// a clearly worthless (or clearly significant) system are wasted. The rule
+// here looks at the running p-value every MCPT_STOP_EVERY replications and
+// stops as soon as a Wilson score interval around it lies entirely above or
+// entirely below alpha.
+//
+// Each look uses z = 3.29 (99.9% two-sided) so that the many looks of a long
+// run still leave the overall chance of stopping on the wrong side of alpha
+// small. Looks happen only at fixed replication counts, so the point at which
+// a run stops depends on the seed alone, not on the thread count.
+#pragma once
+
+#include <math.h>
+
+#define MCPT_STOP_EVERY 50   // Replications between looks (first look at this many)
+#define MCPT_STOP_Z 3.29     // Normal quantile used for the interval at each look
+
+enum {
+  MCPT_STOP_CONTINUE = 0,    // Interval still straddles alpha
+  MCPT_STOP_ABOVE = 1,       // p is clearly above alpha: not significant
+  MCPT_STOP_BELOW = 2        // p is clearly at or below alpha: significant
+};
+
+// Wilson score interval for count successes in n trials
+static inline void mcpt_pvalue_interval(int count, int n, double *lo, double *hi) {
+  double z2 = MCPT_STOP_Z * MCPT_STOP_Z;
+  double p = (double) count / n;
+  double denom = 1.0 + z2 / n;
+  double center = (p + z2 / (2.0 * n)) / denom;
+  double half = MCPT_STOP_Z * sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / denom;
+  *lo = center - half;
+  *hi = center + half;
+  if (*lo < 0.0) *lo = 0.0;
+  if (*hi > 1.0) *hi = 1.0;
+}
+
+// Decide whether a run with `count` of `n` replications at or above the
+// original can stop. Only acts at multiples of MCPT_STOP_EVERY.
+static inline int mcpt_stop_check(int count, int n, double alpha, double *lo, double *hi) {
+  mcpt_pvalue_interval(count, n, lo, hi);
+  if (n < MCPT_STOP_EVERY || n % MCPT_STOP_EVERY) return MCPT_STOP_CONTINUE;
+  if (*lo > alpha) return MCPT_STOP_ABOVE;
+  if (*hi <= alpha) return MCPT_STOP_BELOW;
+  return MCPT_STOP_CONTINUE;
+}
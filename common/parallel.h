@@ -0,0 +1,43 @@
+// Minimal work sharing for the algorithm programs
+//
+// parallel_for(n, nthreads, body) calls body(index, worker) once for every
+// index in [0, n). Indices are handed out one at a time from a shared counter,
+// so uneven work items balance themselves. The calling thread is worker 0.
+// Results must be written to per-index slots and combined afterwards in
+// index order if they are to be independent of the thread count.
+#pragma once
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Resolve a user-supplied thread count (0 or less = all hardware threads)
+static inline int parallel_thread_count(int requested) {
+  if (requested > 0) return requested;
+  unsigned hw = std::thread::hardware_concurrency();
+  return hw > 0 ? (int) hw : 1;
+}
+
+template <class Body>
+static void parallel_for(int n, int nthreads, Body body) {
+  nthreads = parallel_thread_count(nthreads);
+  if (nthreads > n) nthreads = n;
+  if (nthreads <= 1) {
+    for (int index = 0; index < n; index++) body(index, 0);
+    return;
+  }
+
+  std::atomic<int> next(0);
+  auto work = [&](int worker) {
+    for (;;) {
+      int index = next.fetch_add(1);
+      if (index >= n) break;
+      body(index, worker);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (int worker = 1; worker < nthreads; worker++) threads.emplace_back(work, worker);
+  work(0);
+  for (auto &t : threads) t.join();
+}
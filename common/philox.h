@@ -0,0 +1,76 @@
+// Philox4x32-10 counter-based random numbers (Salmon et al., SC'11)
+//
+// A counter-based generator has no evolving state: block c of key k is
+// philox4x32_10(c, k), four 32-bit words computed directly. Any replication
+// can therefore draw its numbers without touching another's, and a stream
+// costs nothing to set up, unlike the 256-word MWC256 of rand32m.h.
+//
+// philox_stream(seed, index) gives stream `index` of `seed`: the key is the
+// seed, the high half of the counter is the index and the low half counts
+// blocks within the stream. Keying streams on the work index rather than the
+// thread makes results identical for any thread count.
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+  uint32_t key[2];
+  uint32_t ctr[4];   // ctr[0..1] = block within the stream, ctr[2..3] = stream index
+  uint32_t out[4];   // Current block
+  int used;          // Words of out already returned
+} PHILOX_STATE;
+
+static inline void philox4x32_10(const uint32_t ctr_in[4], const uint32_t key_in[2], uint32_t out[4]) {
+  uint32_t c0 = ctr_in[0], c1 = ctr_in[1], c2 = ctr_in[2], c3 = ctr_in[3];
+  uint32_t k0 = key_in[0], k1 = key_in[1];
+  for (int round = 0; round < 10; round++) {
+    uint64_t p0 = (uint64_t) 0xD2511F53u * c0;
+    uint64_t p1 = (uint64_t) 0xCD9E8D57u * c2;
+    uint32_t hi0 = (uint32_t) (p0 >> 32), lo0 = (uint32_t) p0;
+    uint32_t hi1 = (uint32_t) (p1 >> 32), lo1 = (uint32_t) p1;
+    c0 = hi1 ^ c1 ^ k0;
+    c1 = lo1;
+    c2 = hi0 ^ c3 ^ k1;
+    c3 = lo0;
+    k0 += 0x9E3779B9u;   // Weyl key schedule
+    k1 += 0xBB67AE85u;
+  }
+  out[0] = c0;
+  out[1] = c1;
+  out[2] = c2;
+  out[3] = c3;
+}
+
+static inline void philox_stream(PHILOX_STATE *state, uint64_t seed, uint64_t index) {
+  state->key[0] = (uint32_t) seed;
+  state->key[1] = (uint32_t) (seed >> 32);
+  state->ctr[0] = state->ctr[1] = 0;
+  state->ctr[2] = (uint32_t) index;
+  state->ctr[3] = (uint32_t) (index >> 32);
+  state->used = 4;
+}
+
+static inline uint32_t philox_next(PHILOX_STATE *state) {
+  if (state->used == 4) {
+    philox4x32_10(state->ctr, state->key, state->out);
+    if (++state->ctr[0] == 0) ++state->ctr[1];
+    state->used = 0;
+  }
+  return state->out[state->used++];
+}
+
+// Uniform in [0, 1], scaled as unifrand() is
+static inline double philox_unifrand(PHILOX_STATE *state) {
+  double mult = 1.0 / 0xFFFFFFFF;
+  return mult * philox_next(state);
+}
+
+// Seed for sub-run `index` of a run with base seed `seed`, so that one user
+// seed can key many independent sets of streams
+static inline uint64_t philox_seed(uint64_t seed, uint64_t index) {
+  uint32_t ctr[4] = {(uint32_t) index, (uint32_t) (index >> 32), 0xFFFFFFFFu, 0xFFFFFFFFu};
+  uint32_t key[2] = {(uint32_t) seed, (uint32_t) (seed >> 32)};
+  uint32_t out[4];
+  philox4x32_10(ctr, key, out);
+  return ((uint64_t) out[1] << 32) | out[0];
+}
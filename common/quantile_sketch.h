@@ -0,0 +1,116 @@
+// Quantiles of replication results without a full sort
+//
+// The bootstrap and drawdown programs collect every replication in an
+// nboot-long array, sort it and read a handful of order statistics.
+//
+// quantile_select finds just those order statistics with nth_element. Each
+// selection partitions the array, so the next (larger) one only searches
+// what lies above the last: O(nboot) per quantile instead of
+// O(nboot log nboot) for the sort. The selected elements are the values the
+// sort would have put there, so results are unchanged.
+//
+// P2Quantile is the P-square estimator of Jain and Chlamtac (CACM 1985):
+// five markers per quantile, adjusted as values stream in. It needs no
+// array at all, at the cost of an approximate result, and suits replication
+// counts too large to keep.
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+// Order statistic used for fraction frac of n values, (int) (frac * (n+1)) - 1
+// as the programs compute it
+static inline int quantile_index(int n, double frac) {
+  int k = (int) (frac * (n + 1)) - 1;
+  if (k < 0) k = 0;
+  if (k > n - 1) k = n - 1;
+  return k;
+}
+
+// Rearrange data so that data[k[j]] holds the element an ascending sort
+// would put there, for each of the nk (not necessarily ordered) indices
+static inline void quantile_select(int n, double *data, int nk, const int *k) {
+  std::vector<int> order(k, k + nk);
+  std::sort(order.begin(), order.end());
+  int lo = 0;
+  for (int kj : order) {
+    if (kj < lo) continue;   // Repeated index
+    std::nth_element(data + lo, data + kj, data + n);
+    lo = kj + 1;
+  }
+}
+
+typedef struct {
+  double p;         // Quantile being estimated, 0-1
+  int count;        // Values seen
+  double q[5];      // Marker heights
+  double pos[5];    // Marker positions (1-origin)
+  double want[5];   // Desired marker positions
+  double step[5];   // Increment of want per value
+} P2Quantile;
+
+static inline void p2_init(P2Quantile *s, double p) {
+  s->p = p;
+  s->count = 0;
+  for (int i = 0; i < 5; i++) s->pos[i] = i + 1;
+  s->want[0] = 1.0;
+  s->want[1] = 1.0 + 2.0 * p;
+  s->want[2] = 1.0 + 4.0 * p;
+  s->want[3] = 3.0 + 2.0 * p;
+  s->want[4] = 5.0;
+  s->step[0] = 0.0;
+  s->step[1] = p / 2.0;
+  s->step[2] = p;
+  s->step[3] = (1.0 + p) / 2.0;
+  s->step[4] = 1.0;
+}
+
+static inline void p2_add(P2Quantile *s, double x) {
+  if (s->count < 5) {   // The first five values become the markers
+    int i = s->count++;
+    for (; i > 0 && s->q[i - 1] > x; i--) s->q[i] = s->q[i - 1];
+    s->q[i] = x;
+    return;
+  }
+  ++s->count;
+
+  int cell;   // Markers above cell move up one place
+  if (x < s->q[0]) {
+    s->q[0] = x;
+    cell = 0;
+  } else if (x >= s->q[4]) {
+    if (x > s->q[4]) s->q[4] = x;
+    cell = 3;
+  } else {
+    cell = 0;
+    while (x >= s->q[cell + 1]) ++cell;
+  }
+  for (int i = cell + 1; i < 5; i++) s->pos[i] += 1.0;
+  for (int i = 0; i < 5; i++) s->want[i] += s->step[i];
+
+  // Move the middle markers toward their desired positions, piecewise-parabolic
+  // when that keeps the heights ordered, otherwise linear
+  for (int i = 1; i < 4; i++) {
+    double d = s->want[i] - s->pos[i];
+    if ((d >= 1.0 && s->pos[i + 1] - s->pos[i] > 1.0) || (d <= -1.0 && s->pos[i - 1] - s->pos[i] < -1.0)) {
+      double ds = d > 0.0 ? 1.0 : -1.0;
+      double qp = s->q[i] + ds / (s->pos[i + 1] - s->pos[i - 1]) *
+                                ((s->pos[i] - s->pos[i - 1] + ds) * (s->q[i + 1] - s->q[i]) / (s->pos[i + 1] - s->pos[i]) +
+                                 (s->pos[i + 1] - s->pos[i] - ds) * (s->q[i] - s->q[i - 1]) / (s->pos[i] - s->pos[i - 1]));
+      if (s->q[i - 1] < qp && qp < s->q[i + 1])
+        s->q[i] = qp;
+      else {
+        int j = i + (int) ds;
+        s->q[i] += ds * (s->q[j] - s->q[i]) / (s->pos[j] - s->pos[i]);
+      }
+      s->pos[i] += ds;
+    }
+  }
+}
+
+// Current estimate; exact (by quantile_index) while five or fewer values are in
+static inline double p2_value(const P2Quantile *s) {
+  if (s->count == 0) return 0.0;
+  if (s->count <= 5) return s->q[quantile_index(s->count, s->p)];
+  return s->q[2];
+}
@@ -0,0 +1,56 @@
+// Reentrant form of Marsaglia's MWC256 generator (RAND32M / unifrand)
+//
+// The algorithm programs each carry a copy of RAND32M with its state in
+// file-level statics, which makes them impossible to share between threads.
+// Here the state lives in a RAND32M_STATE so every worker, or every
+// replication, can own an independent stream.
+//
+// rand32m_stream(seed, index) derives a stream for one unit of work. Keying
+// streams on the work index rather than the thread makes results identical
+// for any thread count.
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+  unsigned int Q[256];
+  unsigned int carry;
+  unsigned char i;
+} RAND32M_STATE;
+
+// Same initialisation as RAND32M_seed(iseed) followed by the first RAND32M()
+static inline void rand32m_init(RAND32M_STATE *state, unsigned int iseed) {
+  unsigned int j = iseed;
+  for (int k = 0; k < 256; k++) {
+    j = 69069 * j + 12345;  // This overflows, doing an automatic mod 2^32
+    state->Q[k] = j;
+  }
+  state->carry = 362436;
+  state->i = 255;
+}
+
+static inline unsigned int rand32m_next(RAND32M_STATE *state) {
+  uint64_t a = 809430660;
+  uint64_t t = a * state->Q[++state->i] + state->carry;  // 64-bit op, forced by a being 64-bit
+  state->carry = (unsigned int) (t >> 32);
+  state->Q[state->i] = (unsigned int) (t & 0xFFFFFFFF);
+  return state->Q[state->i];
+}
+
+static inline double unifrand_r(RAND32M_STATE *state) {
+  double mult = 1.0 / 0xFFFFFFFF;
+  return mult * rand32m_next(state);
+}
+
+// SplitMix64 finaliser; spreads nearby (seed, index) pairs over the seed space
+static inline uint64_t rand32m_mix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+// Independent stream number `index` of base seed `seed`
+static inline void rand32m_stream(RAND32M_STATE *state, uint64_t seed, uint64_t index) {
+  rand32m_init(state, (unsigned int) rand32m_mix(rand32m_mix(seed) ^ index));
+}
@@ -0,0 +1,104 @@
+// Large scratch arrays, optionally backed by a file on disk
+//
+// A program that needs a work array bigger than RAM can ask for it to be
+// mapped from a scratch file instead of malloc'd. The operating system then
+// pages it to and from the file, which is efficient as long as the program
+// walks the array in long sequential runs. The file must not already exist.
+// It is unlinked as soon as it is created, so its disk space is returned when
+// the array is released or the program exits, however it exits.
+//
+// Without mmap (Windows builds) a file-backed request falls back to malloc.
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+typedef struct {
+  void *base;
+  size_t bytes;
+  int mapped;       // Nonzero if base is a file mapping
+} ScratchMap;
+
+// Allocate `bytes` bytes, mapped from `filename` if it is not NULL or empty.
+// Returns 0 on success; otherwise writes a message to errmsg and returns 1.
+static inline int scratch_map_alloc(size_t bytes, const char *filename, ScratchMap *map,
+                                    char *errmsg, size_t errlen) {
+  memset(map, 0, sizeof(*map));
+  map->bytes = bytes;
+
+#if !defined(_WIN32)
+  if (filename != NULL && filename[0]) {
+    int fd = open(filename, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) {
+      snprintf(errmsg, errlen, "Cannot create scratch file %s (it must not already exist)", filename);
+      return 1;
+    }
+    unlink(filename);   // Lives until the mapping and descriptor are gone
+    if (ftruncate(fd, (off_t) bytes) != 0) {
+      close(fd);
+      snprintf(errmsg, errlen, "Cannot extend scratch file %s to %.0lf bytes", filename, (double) bytes);
+      return 1;
+    }
+    map->base = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map->base == MAP_FAILED) {
+      map->base = NULL;
+      snprintf(errmsg, errlen, "Cannot map scratch file %s", filename);
+      return 1;
+    }
+    map->mapped = 1;
+    return 0;
+  }
+#else
+  (void) filename;
+#endif
+
+  map->base = malloc(bytes);
+  if (map->base == NULL) {
+    snprintf(errmsg, errlen, "Insufficient memory for %.0lf bytes of scratch", (double) bytes);
+    return 1;
+  }
+  return 0;
+}
+
+// Tell the system that [offset, offset+len) will not be read again soon, so
+// the pages of a mapped array can be written back and dropped. No-op for
+// malloc'd arrays.
+static inline void scratch_map_release(ScratchMap *map, size_t offset, size_t len) {
+#if !defined(_WIN32) && defined(MADV_DONTNEED)
+  if (map->mapped) {
+    size_t page = (size_t) sysconf(_SC_PAGESIZE);
+    size_t start = (offset + page - 1) / page * page;   // Whole pages inside the range only
+    size_t end = (offset + len) / page * page;
+    if (end > start) {
+      msync((char *) map->base + start, end - start, MS_ASYNC);
+      madvise((char *) map->base + start, end - start, MADV_DONTNEED);
+    }
+  }
+#else
+  (void) map;
+  (void) offset;
+  (void) len;
+#endif
+}
+
+static inline void scratch_map_free(ScratchMap *map) {
+  if (map->base != NULL) {
+#if !defined(_WIN32)
+    if (map->mapped)
+      munmap(map->base, map->bytes);
+    else
+#endif
+      free(map->base);
+  }
+  memset(map, 0, sizeof(*map));
+}
@@ -0,0 +1,187 @@
+#include "bar_loader.h"
+#include "bar_store.h"
+#include "bar_time.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <system_error>
+
+namespace {
+
+constexpr size_t kBlockSize = 1 << 20;  // 1 MiB read blocks
+
+inline bool is_delim(char c) {
+  return c == ' ' || c == '\t' || c == ',';
+}
+
+inline const char* skip_delims(const char* p, const char* end) {
+  while (p < end && is_delim(*p)) ++p;
+  return p;
+}
+
+inline bool parse_double(const char*& p, const char* end, double& out) {
+  if (p < end && *p == '+') ++p;  // from_chars does not accept a leading '+'
+  auto result = std::from_chars(p, end, out);
+  if (result.ec != std::errc()) return false;
+  p = result.ptr;
+  return true;
+}
+
+struct FileCloser {
+  void operator()(std::FILE* f) const { std::fclose(f); }
+};
+
+}  // namespace
+
+namespace BarLoader {
+
+// Binary stores (tools/txt_to_bars) are already parsed; every row is a bar
+static bool for_each_stored_bar(const std::string& filename,
+                                const BarVisitor& on_bar,
+                                LoadStats* stats) {
+  BarStore store;
+  if (bar_store_open(filename.c_str(), &store, nullptr)) {
+    return false;
+  }
+
+  LoadStats local;
+  for (int64_t i = 0; i < store.nrows; ++i) {
+    Bar bar;
+    bar.date = store.date ? store.date[i] : 0;
+    bar.open = store.open ? store.open[i] : 0.0;
+    bar.high = store.high ? store.high[i] : 0.0;
+    bar.low = store.low ? store.low[i] : 0.0;
+    bar.close = store.close ? store.close[i] : 0.0;
+    bar.volume = store.volume ? store.volume[i] : 0.0;
+    bar.timestamp = store.timestamp ? store.timestamp[i] : bar_date_to_epoch_ms(bar.date);
+    ++local.line_count;
+    ++local.valid_bars;
+    on_bar(bar);
+  }
+
+  bar_store_close(&store);
+  if (stats) *stats = local;
+  return true;
+}
+
+bool parse_bar_line(const char* begin, const char* end, Bar& out) {
+  if (end - begin < 8) return false;
+
+  int date = 0;
+  for (int i = 0; i < 8; ++i) {
+    char c = begin[i];
+    if (c < '0' || c > '9') return false;
+    date = date * 10 + (c - '0');
+  }
+  out.date = date;
+
+  // Ignore the rest of the date token (time-of-day suffixes and the like)
+  const char* p = begin + 8;
+  while (p < end && !is_delim(*p)) ++p;
+
+  double* required[] = {&out.open, &out.high, &out.low, &out.close};
+  for (double* field : required) {
+    p = skip_delims(p, end);
+    if (p >= end || !parse_double(p, end, *field)) return false;
+  }
+
+  p = skip_delims(p, end);
+  if (p >= end || !parse_double(p, end, out.volume)) {
+    out.volume = 0.0;
+  }
+
+  // Optional epoch-millisecond timestamp after the volume
+  out.timestamp = 0;
+  p = skip_delims(p, end);
+  if (p < end) {
+    auto result = std::from_chars(p, end, out.timestamp);
+    if (result.ec != std::errc()) out.timestamp = 0;
+  }
+  if (out.timestamp == 0) out.timestamp = bar_date_to_epoch_ms(out.date);
+
+  return std::isfinite(out.open) && std::isfinite(out.high) &&
+         std::isfinite(out.low) && std::isfinite(out.close);
+}
+
+bool for_each_bar(const std::string& filename,
+                  const BarVisitor& on_bar,
+                  const InvalidLineVisitor& on_invalid,
+                  LoadStats* stats) {
+  if (bar_store_is_binary(filename.c_str())) {
+    return for_each_stored_bar(filename, on_bar, stats);
+  }
+
+  std::unique_ptr<std::FILE, FileCloser> file(std::fopen(filename.c_str(), "rb"));
+  if (!file) return false;
+
+  // Small files get a buffer of their own size rather than a full block
+  size_t block = kBlockSize;
+  if (std::fseek(file.get(), 0, SEEK_END) == 0) {
+    long size = std::ftell(file.get());
+    if (size >= 0 && static_cast<size_t>(size) < block) block = static_cast<size_t>(size) + 1;
+    std::rewind(file.get());
+  }
+
+  LoadStats local;
+  std::vector<char> buffer(block);
+  size_t carried = 0;  // Bytes of an incomplete line kept from the last block
+  bool eof = false;
+
+  auto handle_line = [&](const char* begin, const char* end) {
+    ++local.line_count;
+    if (end > begin && end[-1] == '\r') --end;
+    if (end - begin < 2) return;
+
+    Bar bar;
+    if (parse_bar_line(begin, end, bar)) {
+      ++local.valid_bars;
+      on_bar(bar);
+    } else {
+      ++local.invalid_lines;
+      if (on_invalid) on_invalid(local.line_count);
+    }
+  };
+
+  while (!eof) {
+    // A single line longer than the buffer: grow instead of splitting it
+    if (carried == buffer.size()) {
+      buffer.resize(buffer.size() * 2);
+    }
+
+    size_t got = std::fread(buffer.data() + carried, 1, buffer.size() - carried, file.get());
+    if (got == 0) eof = true;
+
+    const char* data = buffer.data();
+    const char* end = data + carried + got;
+    const char* line = data;
+
+    for (;;) {
+      const char* nl = static_cast<const char*>(std::memchr(line, '\n', end - line));
+      if (!nl) break;
+      handle_line(line, nl);
+      line = nl + 1;
+    }
+
+    carried = static_cast<size_t>(end - line);
+    if (eof) {
+      if (carried > 0) handle_line(line, end);
+    } else if (carried > 0 && line != data) {
+      std::memmove(buffer.data(), line, carried);
+    }
+  }
+
+  if (stats) *stats = local;
+  return true;
+}
+
+bool load_bars(const std::string& filename,
+               std::vector<Bar>& bars,
+               LoadStats* stats) {
+  bars.clear();
+  return for_each_bar(filename, [&](const Bar& bar) { bars.push_back(bar); }, nullptr, stats);
+}
+
+}  // namespace BarLoader
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "strategy.h"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Fast loader for "YYYYMMDD Open High Low Close [Volume [EpochMs]]" text files.
+//
+// The file is read in large blocks and every line is parsed in place with
+// std::from_chars: there is no per-line std::string, stream or substr, and
+// parsing does not depend on the global locale. Fields may be separated by
+// spaces, tabs or commas; CRLF line endings are accepted.
+//
+// Binary bar stores written by tools/txt_to_bars (common/bar_store.h) are
+// detected by their magic and read directly; each row counts as one line.
+namespace BarLoader {
+
+// Line-level outcome reported to the visitor
+struct LoadStats {
+  size_t line_count = 0;     // Physical lines read
+  size_t valid_bars = 0;     // Lines parsed into a bar
+  size_t invalid_lines = 0;  // Non-blank lines that failed to parse
+};
+
+// Parse one line (without the terminator) into `out`.
+//
+// The first 8 characters must be digits (YYYYMMDD); any further characters
+// of that token (e.g. an HHMM suffix) are ignored. Open, high, low and close
+// are required and must be finite. Volume is optional and defaults to 0.
+// The epoch-millisecond timestamp may follow the volume; without it the
+// timestamp is midnight UTC of the date.
+bool parse_bar_line(const char* begin, const char* end, Bar& out);
+
+// Called for every parsed bar, in file order
+using BarVisitor = std::function<void(const Bar&)>;
+
+// Called with the 1-based line number of every malformed line.
+// Lines shorter than two characters are treated as blank and skipped silently.
+using InvalidLineVisitor = std::function<void(size_t)>;
+
+// Stream the bars of `filename` through `on_bar` without materialising them.
+// Returns false if the file cannot be opened (or is a corrupt bar store).
+bool for_each_bar(const std::string& filename,
+                  const BarVisitor& on_bar,
+                  const InvalidLineVisitor& on_invalid = nullptr,
+                  LoadStats* stats = nullptr);
+
+// Load every valid bar of `filename`. Returns false if it cannot be opened.
+bool load_bars(const std::string& filename,
+               std::vector<Bar>& bars,
+               LoadStats* stats = nullptr);
+
+}  // namespace BarLoader
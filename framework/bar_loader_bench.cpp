@@ -0,0 +1,208 @@
+// Throughput benchmark: BarLoader vs the per-line parsers it replaced.
+//
+// Usage: bar_loader_bench <ohlc_file> [repetitions]
+//
+// "runner (substr+stod)" is the old strategy_runner parse_ohlc_line and
+// "batch (istringstream)" is the old strategy_batch_tester load_market_data;
+// both are kept here verbatim as the reference. Every parser must produce the
+// same bars, otherwise the benchmark exits non-zero.
+
+#include "bar_loader.h"
+#include "strategy.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+// --- Reference: strategy_runner parser (substr + std::stod per field) ---
+
+bool legacy_runner_parse(const std::string& line, Bar& out) {
+  if (line.length() < 8) return false;
+
+  size_t pos = 0;
+  std::string date_str = line.substr(0, 8);
+  for (char c : date_str) {
+    if (c < '0' || c > '9') return false;
+  }
+  out.date = std::stoi(date_str);
+
+  pos = 8;
+  auto skip_delim = [&]() {
+    while (pos < line.length() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == ',')) ++pos;
+  };
+
+  skip_delim();
+  if (pos >= line.length()) return false;
+  size_t end_pos;
+  out.open = std::stod(line.substr(pos), &end_pos);
+  pos += end_pos;
+
+  skip_delim();
+  if (pos >= line.length()) return false;
+  out.high = std::stod(line.substr(pos), &end_pos);
+  pos += end_pos;
+
+  skip_delim();
+  if (pos >= line.length()) return false;
+  out.low = std::stod(line.substr(pos), &end_pos);
+  pos += end_pos;
+
+  skip_delim();
+  if (pos >= line.length()) return false;
+  out.close = std::stod(line.substr(pos), &end_pos);
+  pos += end_pos;
+
+  skip_delim();
+  if (pos < line.length()) {
+    out.volume = std::stod(line.substr(pos), &end_pos);
+  } else {
+    out.volume = 0.0;
+  }
+
+  if (!std::isfinite(out.open) || !std::isfinite(out.high) ||
+      !std::isfinite(out.low) || !std::isfinite(out.close)) {
+    return false;
+  }
+
+  return true;
+}
+
+std::vector<Bar> legacy_runner_load(const std::string& filename) {
+  std::vector<Bar> bars;
+  std::ifstream file(filename);
+  std::string line;
+
+  while (std::getline(file, line)) {
+    if (line.length() < 2) continue;
+
+    Bar bar;
+    try {
+      if (legacy_runner_parse(line, bar)) bars.push_back(bar);
+    } catch (const std::exception&) {
+      // The original runner aborted here; count the line as invalid instead
+    }
+  }
+  return bars;
+}
+
+// --- Reference: strategy_batch_tester parser (istringstream per line) ---
+
+std::vector<Bar> legacy_batch_load(const std::string& filename) {
+  std::vector<Bar> bars;
+  std::ifstream file(filename);
+  std::string line;
+
+  while (std::getline(file, line)) {
+    if (line.length() < 2) continue;
+
+    std::istringstream iss(line);
+    Bar bar;
+
+    std::string date_str;
+    if (!(iss >> date_str)) continue;
+
+    try {
+      bar.date = std::stoi(date_str.substr(0, 8));
+    } catch (const std::exception&) {
+      continue;
+    }
+
+    if (!(iss >> bar.open >> bar.high >> bar.low >> bar.close)) {
+      continue;
+    }
+
+    if (!(iss >> bar.volume)) {
+      bar.volume = 0.0;
+    }
+
+    bars.push_back(bar);
+  }
+  return bars;
+}
+
+std::vector<Bar> bar_loader_load(const std::string& filename) {
+  std::vector<Bar> bars;
+  BarLoader::load_bars(filename, bars);
+  return bars;
+}
+
+bool same_bars(const std::vector<Bar>& a, const std::vector<Bar>& b) {
+  if (a.size() != b.size()) return false;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (a[i].date != b[i].date || a[i].open != b[i].open || a[i].high != b[i].high ||
+        a[i].low != b[i].low || a[i].close != b[i].close || a[i].volume != b[i].volume) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::cout << "Usage: bar_loader_bench <ohlc_file> [repetitions]" << std::endl;
+    return 1;
+  }
+
+  const std::string filename = argv[1];
+  const int repetitions = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+  std::ifstream probe(filename, std::ios::binary | std::ios::ate);
+  if (!probe.is_open()) {
+    std::cout << "Cannot open file: " << filename << std::endl;
+    return 1;
+  }
+  const double megabytes = static_cast<double>(probe.tellg()) / (1024.0 * 1024.0);
+  probe.close();
+
+  struct Candidate {
+    const char* name;
+    std::vector<Bar> (*load)(const std::string&);
+  };
+  const Candidate candidates[] = {
+    {"runner (substr+stod)", legacy_runner_load},
+    {"batch (istringstream)", legacy_batch_load},
+    {"BarLoader (from_chars)", bar_loader_load},
+  };
+
+  std::vector<Bar> reference = bar_loader_load(filename);
+  std::cout << "File: " << filename << " (" << std::fixed << std::setprecision(2) << megabytes
+            << " MiB, " << reference.size() << " bars), best of " << repetitions << std::endl;
+  std::cout << std::left << std::setw(26) << "Parser" << std::right << std::setw(12) << "ms"
+            << std::setw(12) << "MiB/s" << std::setw(14) << "Mbars/s" << std::endl;
+
+  bool all_match = true;
+  for (const Candidate& candidate : candidates) {
+    double best_ms = 0.0;
+    std::vector<Bar> bars;
+
+    for (int rep = 0; rep < repetitions; ++rep) {
+      auto start = std::chrono::steady_clock::now();
+      bars = candidate.load(filename);
+      auto stop = std::chrono::steady_clock::now();
+
+      double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+      if (rep == 0 || ms < best_ms) best_ms = ms;
+    }
+
+    bool match = same_bars(bars, reference);
+    all_match = all_match && match;
+
+    double seconds = std::max(best_ms, 1e-6) / 1000.0;
+    std::cout << std::left << std::setw(26) << candidate.name << std::right << std::setw(12)
+              << std::setprecision(2) << best_ms << std::setw(12) << (megabytes / seconds)
+              << std::setw(14) << std::setprecision(3) << (bars.size() / seconds / 1e6)
+              << (match ? "" : "  MISMATCH") << std::endl;
+  }
+
+  return all_match ? 0 : 1;
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "strategy.h"
+#include "bar_time.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Time-ordering key of a bar: its timestamp, or midnight UTC of its date
+// when the source had no intraday timestamps
+inline int64_t bar_timestamp(const Bar& bar) {
+  return bar.timestamp != 0 ? bar.timestamp : bar_date_to_epoch_ms(bar.date);
+}
+
+// Non-owning, read-only view of a contiguous run of bars.
+// Cheap to copy; the caller keeps the underlying storage alive.
+class BarSpan {
+public:
+  BarSpan() = default;
+  BarSpan(const Bar* data, size_t size) : data_(data), size_(size) {}
+  BarSpan(const std::vector<Bar>& bars) : data_(bars.data()), size_(bars.size()) {}
+
+  const Bar* data() const { return data_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const Bar& operator[](size_t i) const { return data_[i]; }
+  const Bar& front() const { return data_[0]; }
+  const Bar& back() const { return data_[size_ - 1]; }
+
+  const Bar* begin() const { return data_; }
+  const Bar* end() const { return data_ + size_; }
+
+  // Sub-view [offset, offset + count), clamped to the span
+  BarSpan subspan(size_t offset, size_t count = static_cast<size_t>(-1)) const {
+    offset = std::min(offset, size_);
+    count = std::min(count, size_ - offset);
+    return BarSpan(data_ + offset, count);
+  }
+
+  // First index whose timestamp is >= ts_ms (size() if none).
+  // Bars must be in time order; O(log n).
+  size_t lower_bound_time(int64_t ts_ms) const {
+    const Bar* it = std::lower_bound(begin(), end(), ts_ms, [](const Bar& bar, int64_t ts) {
+      return bar_timestamp(bar) < ts;
+    });
+    return static_cast<size_t>(it - begin());
+  }
+
+private:
+  const Bar* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// Reference-counted, immutable market dataset.
+//
+// Load the bars once, then hand BarSeries handles to every StrategyMetrics,
+// worker thread and train/test split. Copies and slices share one buffer;
+// the bars are freed when the last handle goes away.
+class BarSeries {
+public:
+  // Verdict of StrategyTester::validate_dataset on this view. Copies share
+  // it, so the checks run once however many configs test the series; every
+  // slice starts with a fresh one.
+  struct Validation {
+    std::once_flag once;
+    std::string error;  // Empty if the bars passed
+  };
+
+  BarSeries() = default;
+
+  // Takes ownership of the bars (move in to avoid a copy)
+  explicit BarSeries(std::vector<Bar> bars)
+      : storage_(std::make_shared<const std::vector<Bar>>(std::move(bars))),
+        offset_(0),
+        size_(storage_->size()) {}
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  const Bar* data() const { return storage_ ? storage_->data() + offset_ : nullptr; }
+  const Bar& operator[](size_t i) const { return data()[i]; }
+  const Bar& front() const { return data()[0]; }
+  const Bar& back() const { return data()[size_ - 1]; }
+
+  const Bar* begin() const { return data(); }
+  const Bar* end() const { return data() + size_; }
+
+  BarSpan view() const { return BarSpan(data(), size_); }
+  operator BarSpan() const { return view(); }
+
+  // Zero-copy slice [offset, offset + count), clamped to this series
+  BarSeries slice(size_t offset, size_t count = static_cast<size_t>(-1)) const {
+    offset = std::min(offset, size_);
+    count = std::min(count, size_ - offset);
+
+    BarSeries out;
+    out.storage_ = storage_;
+    out.offset_ = offset_ + offset;
+    out.size_ = count;
+    return out;
+  }
+
+  // Zero-copy slice of the bars with timestamps in [begin_ms, end_ms).
+  // Bars must be in time order; the bounds are found by binary search.
+  BarSeries slice_time(int64_t begin_ms, int64_t end_ms) const {
+    BarSpan all = view();
+    size_t first = all.lower_bound_time(begin_ms);
+    size_t last = std::max(first, all.lower_bound_time(end_ms));
+    return slice(first, last - first);
+  }
+
+  // Zero-copy slice of the calendar dates [first_date, last_date] (YYYYMMDD,
+  // inclusive), including every intraday bar of those days
+  BarSeries slice_dates(int first_date, int last_date) const {
+    return slice_time(bar_date_to_epoch_ms(first_date),
+                      bar_date_to_epoch_ms(last_date) + BAR_MS_PER_DAY);
+  }
+
+  // Train/test split: first train_count bars, then the remainder
+  std::pair<BarSeries, BarSeries> split(size_t train_count) const {
+    if (train_count > size_) {
+      throw std::out_of_range("BarSeries::split: train_count exceeds series length");
+    }
+    return {slice(0, train_count), slice(train_count)};
+  }
+
+  // Explicit deep copy for callers that need a mutable vector
+  std::vector<Bar> to_vector() const { return std::vector<Bar>(begin(), end()); }
+
+  // True when both handles view the same bars of the same buffer
+  bool same_view(const BarSeries& other) const {
+    return storage_ == other.storage_ && offset_ == other.offset_ && size_ == other.size_;
+  }
+
+  long use_count() const { return storage_.use_count(); }
+
+  Validation& validation() const { return *validation_; }
+
+private:
+  std::shared_ptr<const std::vector<Bar>> storage_;
+  size_t offset_ = 0;
+  size_t size_ = 0;
+  std::shared_ptr<Validation> validation_ = std::make_shared<Validation>();
+};
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include "ring_buffer.h"
+
+// Incremental indicator library for the framework strategies.
+//
+// Every indicator consumes one observation per update() and keeps only the
+// state it needs, so per-bar cost is O(1) no matter how long the history is.
+namespace Indicators {
+
+// Simple moving average of the last `period` values.
+// The window sum is rebuilt from the window once per `period` updates,
+// which bounds floating-point drift at amortised O(1) cost.
+class RunningSma {
+public:
+  explicit RunningSma(int period = 1) { reset(period); }
+
+  void reset(int period) {
+    period_ = std::max(1, period);
+    window_.reset(static_cast<size_t>(period_));
+    reset();
+  }
+
+  void reset() {
+    window_.clear();
+    updates_since_resum_ = 0;
+    sum_ = 0.0;
+  }
+
+  void update(double value) {
+    if (window_.full()) {
+      sum_ -= window_.oldest();
+    }
+    window_.push_back(value);
+    sum_ += value;
+
+    if (++updates_since_resum_ >= period_ && window_.full()) {
+      sum_ = 0.0;
+      for (size_t i = 0; i < window_.size(); ++i) sum_ += window_[i];
+      updates_since_resum_ = 0;
+    }
+  }
+
+  bool ready() const { return window_.full(); }
+  int period() const { return period_; }
+  int count() const { return static_cast<int>(window_.size()); }
+  double sum() const { return sum_; }
+  double value() const { return window_.empty() ? 0.0 : sum_ / static_cast<double>(window_.size()); }
+
+private:
+  RingBuffer<double> window_;
+  int period_ = 1;
+  int updates_since_resum_ = 0;
+  double sum_ = 0.0;
+};
+
+// Exponential moving average with alpha = 2 / (period + 1).
+// Seeds itself with the mean of the first `period` updates unless seed() is
+// called first (e.g. with a RunningSma of the most recent window).
+class Ema {
+public:
+  explicit Ema(int period = 1) { reset(period); }
+
+  void reset(int period) {
+    period_ = std::max(1, period);
+    multiplier_ = 2.0 / (period_ + 1.0);
+    reset();
+  }
+
+  void reset() {
+    ready_ = false;
+    seed_count_ = 0;
+    seed_sum_ = 0.0;
+    value_ = 0.0;
+  }
+
+  void seed(double value) {
+    value_ = value;
+    ready_ = true;
+  }
+
+  void update(double value) {
+    if (!ready_) {
+      seed_sum_ += value;
+      if (++seed_count_ == period_) {
+        seed(seed_sum_ / period_);
+      }
+      return;
+    }
+    value_ = (value * multiplier_) + (value_ * (1.0 - multiplier_));
+  }
+
+  bool ready() const { return ready_; }
+  int period() const { return period_; }
+  double value() const { return value_; }
+
+private:
+  int period_ = 1;
+  double multiplier_ = 1.0;
+  bool ready_ = false;
+  int seed_count_ = 0;
+  double seed_sum_ = 0.0;
+  double value_ = 0.0;
+};
+
+// Wilder RSI on closing prices.
+// Average gain/loss are seeded with the simple mean of the first `period`
+// changes and smoothed as avg = (avg * (period - 1) + x) / period afterwards.
+class WilderRsi {
+public:
+  explicit WilderRsi(int period = 14) { reset(period); }
+
+  void reset(int period) {
+    period_ = std::max(1, period);
+    reset();
+  }
+
+  void reset() {
+    has_prev_ = false;
+    ready_ = false;
+    seed_count_ = 0;
+    prev_close_ = 0.0;
+    avg_gain_ = 0.0;
+    avg_loss_ = 0.0;
+  }
+
+  void update(double close) {
+    if (!has_prev_) {
+      prev_close_ = close;
+      has_prev_ = true;
+      return;
+    }
+
+    double change = close - prev_close_;
+    prev_close_ = close;
+    double gain = change > 0.0 ? change : 0.0;
+    double loss = change < 0.0 ? -change : 0.0;
+
+    if (!ready_) {
+      avg_gain_ += gain;
+      avg_loss_ += loss;
+      if (++seed_count_ == period_) {
+        avg_gain_ /= period_;
+        avg_loss_ /= period_;
+        ready_ = true;
+      }
+      return;
+    }
+
+    avg_gain_ = (avg_gain_ * (period_ - 1) + gain) / period_;
+    avg_loss_ = (avg_loss_ * (period_ - 1) + loss) / period_;
+  }
+
+  bool ready() const { return ready_; }
+  int period() const { return period_; }
+  double avg_gain() const { return ready_ ? avg_gain_ : 0.0; }
+  double avg_loss() const { return ready_ ? avg_loss_ : 0.0; }
+
+  // 50 (neutral) until ready; 100 when there have been no losses
+  double value() const {
+    if (!ready_) return 50.0;
+    if (avg_loss_ > 0.0) {
+      double rs = avg_gain_ / avg_loss_;
+      return 100.0 - (100.0 / (1.0 + rs));
+    }
+    return 100.0;
+  }
+
+private:
+  int period_ = 14;
+  bool has_prev_ = false;
+  bool ready_ = false;
+  int seed_count_ = 0;
+  double prev_close_ = 0.0;
+  double avg_gain_ = 0.0;
+  double avg_loss_ = 0.0;
+};
+
+// Average true range: simple average of the last `period` true ranges
+class RunningAtr {
+public:
+  explicit RunningAtr(int period = 14) : true_ranges_(period) {}
+
+  void reset(int period) {
+    true_ranges_.reset(period);
+    has_prev_ = false;
+    prev_close_ = 0.0;
+  }
+
+  void reset() { reset(true_ranges_.period()); }
+
+  void update(double high, double low, double close) {
+    if (has_prev_) {
+      double tr = std::max({high - low,
+                            std::abs(high - prev_close_),
+                            std::abs(low - prev_close_)});
+      true_ranges_.update(tr);
+    }
+    prev_close_ = close;
+    has_prev_ = true;
+  }
+
+  bool ready() const { return true_ranges_.ready(); }
+  double value() const { return ready() ? true_ranges_.value() : 0.0; }
+
+private:
+  RunningSma true_ranges_;
+  bool has_prev_ = false;
+  double prev_close_ = 0.0;
+};
+
+// Welford running mean / sample variance
+class WelfordStats {
+public:
+  void reset() {
+    count_ = 0;
+    mean_ = 0.0;
+    m2_ = 0.0;
+  }
+
+  void update(double x) {
+    ++count_;
+    double delta = x - mean_;
+    mean_ += delta / static_cast<double>(count_);
+    m2_ += delta * (x - mean_);
+  }
+
+  size_t count() const { return count_; }
+  double mean() const { return mean_; }
+  double variance() const { return count_ > 1 ? m2_ / static_cast<double>(count_ - 1) : 0.0; }
+  double stddev() const { return std::sqrt(variance()); }
+
+private:
+  size_t count_ = 0;
+  double mean_ = 0.0;
+  double m2_ = 0.0;
+};
+
+// Volatility of simple close-to-close returns over the whole history
+class ReturnVolatility {
+public:
+  void reset() {
+    stats_.reset();
+    price_count_ = 0;
+    prev_price_ = 0.0;
+  }
+
+  void update(double price) {
+    if (price_count_ > 0 && prev_price_ != 0.0) {
+      stats_.update((price - prev_price_) / prev_price_);
+    }
+    prev_price_ = price;
+    ++price_count_;
+  }
+
+  size_t price_count() const { return price_count_; }
+  size_t return_count() const { return stats_.count(); }
+  double mean() const { return stats_.mean(); }
+  double stddev() const { return stats_.stddev(); }
+
+private:
+  WelfordStats stats_;
+  size_t price_count_ = 0;
+  double prev_price_ = 0.0;
+};
+
+// Running win/loss counters over completed trades (Kelly sizing inputs)
+class TradeStats {
+public:
+  void reset() {
+    completed_ = 0;
+    wins_ = 0;
+    losses_ = 0;
+    total_win_ = 0.0;
+    total_loss_ = 0.0;
+  }
+
+  void record(double pnl) {
+    ++completed_;
+    if (pnl > 0.0) {
+      ++wins_;
+      total_win_ += pnl;
+    } else if (pnl < 0.0) {
+      ++losses_;
+      total_loss_ += pnl;
+    }
+  }
+
+  int completed() const { return completed_; }
+  double win_rate() const { return completed_ > 0 ? static_cast<double>(wins_) / completed_ : 0.0; }
+  double avg_win() const { return wins_ > 0 ? total_win_ / wins_ : 0.0; }
+  double avg_loss() const { return losses_ > 0 ? total_loss_ / losses_ : 0.0; }  // Negative
+
+private:
+  int completed_ = 0;
+  int wins_ = 0;
+  int losses_ = 0;
+  double total_win_ = 0.0;
+  double total_loss_ = 0.0;
+};
+
+}  // namespace Indicators
@@ -0,0 +1,275 @@
+#include "log.h"
+
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <utility>
+
+namespace Log {
+
+std::atomic<int> g_level{static_cast<int>(Level::Info)};
+
+namespace {
+
+std::atomic<int> g_format{static_cast<int>(Format::Text)};
+
+std::mutex g_sink_mutex;
+std::shared_ptr<Sink> g_sink;
+
+std::shared_ptr<Sink> current_sink() {
+  std::lock_guard<std::mutex> lock(g_sink_mutex);
+  if (!g_sink) g_sink = std::make_shared<StreamSink>();
+  return g_sink;
+}
+
+const char* level_name(Level level) {
+  switch (level) {
+    case Level::Debug: return "debug";
+    case Level::Info: return "info";
+    case Level::Warn: return "warn";
+    case Level::Error: return "error";
+    default: return "off";
+  }
+}
+
+void append_json_string(std::string& out, const std::string& text) {
+  out += '"';
+  for (char c : text) {
+    switch (c) {
+      case '"': out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+      case '\t': out += "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char buf[8];
+          std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+          out += buf;
+        } else {
+          out += c;
+        }
+    }
+  }
+  out += '"';
+}
+
+void append_json_number(std::string& out, double value) {
+  if (!std::isfinite(value)) {
+    out += "null";
+    return;
+  }
+  char buf[32];
+  auto result = std::to_chars(buf, buf + sizeof(buf), value);  // Shortest round-trip form
+  out.append(buf, result.ptr);
+}
+
+}  // namespace
+
+StreamSink::StreamSink(std::ostream& out) : out_(out) {}
+
+void StreamSink::write(Level, const std::string& message) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  out_ << message;
+}
+
+void StreamSink::flush() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  out_.flush();
+}
+
+struct AsyncSink::State {
+  std::shared_ptr<Sink> target;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable drained;
+  std::deque<std::pair<Level, std::string>> queue;
+  bool busy = false;
+  bool stop = false;
+  std::thread writer;
+};
+
+AsyncSink::AsyncSink(std::shared_ptr<Sink> target) : state_(new State) {
+  state_->target = std::move(target);
+  State* state = state_.get();
+  state->writer = std::thread([state] {
+    std::deque<std::pair<Level, std::string>> batch;
+    std::unique_lock<std::mutex> lock(state->mutex);
+    for (;;) {
+      state->wake.wait(lock, [state] { return state->stop || !state->queue.empty(); });
+      if (state->queue.empty()) break;  // Stopping and drained
+
+      batch.swap(state->queue);
+      state->busy = true;
+      lock.unlock();
+      for (const auto& entry : batch) {
+        state->target->write(entry.first, entry.second);
+      }
+      state->target->flush();
+      batch.clear();
+      lock.lock();
+      state->busy = false;
+      if (state->queue.empty()) state->drained.notify_all();
+    }
+  });
+}
+
+AsyncSink::~AsyncSink() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->stop = true;
+  }
+  state_->wake.notify_one();
+  state_->writer.join();
+}
+
+void AsyncSink::write(Level level, const std::string& message) {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->queue.emplace_back(level, message);
+  }
+  state_->wake.notify_one();
+}
+
+void AsyncSink::flush() {
+  std::unique_lock<std::mutex> lock(state_->mutex);
+  state_->drained.wait(lock, [this] { return state_->queue.empty() && !state_->busy; });
+}
+
+void set_level(Level level) {
+  g_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+Level level() {
+  return static_cast<Level>(g_level.load(std::memory_order_relaxed));
+}
+
+void set_format(Format format) {
+  g_format.store(static_cast<int>(format), std::memory_order_relaxed);
+}
+
+Format format() {
+  return static_cast<Format>(g_format.load(std::memory_order_relaxed));
+}
+
+void set_sink(std::shared_ptr<Sink> sink) {
+  std::shared_ptr<Sink> previous;
+  {
+    std::lock_guard<std::mutex> lock(g_sink_mutex);
+    previous = std::move(g_sink);
+    g_sink = std::move(sink);
+  }
+  if (previous) previous->flush();
+}
+
+void flush() {
+  current_sink()->flush();
+}
+
+bool parse_level(const std::string& name, Level& out) {
+  static const Level levels[] = {Level::Debug, Level::Info, Level::Warn, Level::Error, Level::Off};
+  for (Level candidate : levels) {
+    if (name == level_name(candidate)) {
+      out = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+void write(Level level, const std::string& message) {
+  if (!enabled(level) || message.empty()) return;
+
+  if (format() == Format::Text) {
+    current_sink()->write(level, message);
+    return;
+  }
+
+  // Json: prose is only kept for warnings and errors
+  if (level < Level::Warn) return;
+
+  std::string text = message;
+  while (!text.empty() && (text.back() == '\n' || text.back() == '\r')) text.pop_back();
+  size_t start = text.find_first_not_of('\n');
+  text = (start == std::string::npos) ? std::string() : text.substr(start);
+
+  std::string json = "{\"level\":\"";
+  json += level_name(level);
+  json += "\",\"msg\":";
+  append_json_string(json, text);
+  json += "}\n";
+  current_sink()->write(level, json);
+}
+
+Line::Line(Level level) : level_(level), active_(enabled(level)) {}
+
+Line::~Line() {
+  if (active_) write(level_, out_.str());
+}
+
+Event::Event(const char* name, Level level)
+    : level_(level), active_(format() == Format::Json && enabled(level)) {
+  if (active_) {
+    json_ = "{\"event\":";
+    append_json_string(json_, name);
+  }
+}
+
+Event::~Event() {
+  if (!active_) return;
+  json_ += "}\n";
+  current_sink()->write(level_, json_);
+}
+
+Event& Event::field(const char* key, double value) {
+  if (!active_) return *this;
+  json_ += ',';
+  append_json_string(json_, key);
+  json_ += ':';
+  append_json_number(json_, value);
+  return *this;
+}
+
+Event& Event::field(const char* key, int64_t value) {
+  if (!active_) return *this;
+  json_ += ',';
+  append_json_string(json_, key);
+  json_ += ':';
+  json_ += std::to_string(value);
+  return *this;
+}
+
+Event& Event::field(const char* key, bool value) {
+  if (!active_) return *this;
+  json_ += ',';
+  append_json_string(json_, key);
+  json_ += value ? ":true" : ":false";
+  return *this;
+}
+
+Event& Event::field(const char* key, const std::string& value) {
+  if (!active_) return *this;
+  json_ += ',';
+  append_json_string(json_, key);
+  json_ += ':';
+  append_json_string(json_, value);
+  return *this;
+}
+
+Event& Event::field(const char* key, const std::vector<double>& values) {
+  if (!active_) return *this;
+  json_ += ',';
+  append_json_string(json_, key);
+  json_ += ":[";
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (i > 0) json_ += ',';
+    append_json_number(json_, values[i]);
+  }
+  json_ += ']';
+  return *this;
+}
+
+}  // namespace Log
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Leveled logging for the framework.
+//
+// Messages go to a process-wide sink (stdout by default). In Text format a
+// message is written exactly as built, so default output is unchanged from
+// plain std::cout. In Json format prose below Warn is dropped and structured
+// records (Log::Event) are written as one JSON object per line; warnings and
+// errors are wrapped as {"level":..,"msg":..}.
+//
+// Batch runs can route everything through an AsyncSink so worker threads
+// only append to a queue and never wait on the console.
+namespace Log {
+
+enum class Level { Debug = 0, Info, Warn, Error, Off };
+enum class Format { Text, Json };
+
+// Destination for finished messages; implementations must be thread-safe
+class Sink {
+public:
+  virtual ~Sink() = default;
+  virtual void write(Level level, const std::string& message) = 0;
+  virtual void flush() {}
+};
+
+// Writes to an ostream (std::cout by default) under a mutex
+class StreamSink : public Sink {
+public:
+  explicit StreamSink(std::ostream& out = std::cout);
+  void write(Level level, const std::string& message) override;
+  void flush() override;
+
+private:
+  std::ostream& out_;
+  std::mutex mutex_;
+};
+
+// Queues messages and forwards them to `target` on a background thread.
+// flush() blocks until everything queued so far has been written.
+class AsyncSink : public Sink {
+public:
+  explicit AsyncSink(std::shared_ptr<Sink> target);
+  ~AsyncSink() override;
+  void write(Level level, const std::string& message) override;
+  void flush() override;
+
+private:
+  struct State;
+  std::unique_ptr<State> state_;
+};
+
+void set_level(Level level);
+Level level();
+inline bool enabled(Level message_level);
+
+void set_format(Format format);
+Format format();
+
+// nullptr restores the default stdout sink
+void set_sink(std::shared_ptr<Sink> sink);
+void flush();
+
+// "debug", "info", "warn", "error" or "off"
+bool parse_level(const std::string& name, Level& out);
+
+// Submit a finished message (no-op when below the level)
+void write(Level level, const std::string& message);
+
+// Builds one message and submits it when destroyed, so a multi-line block
+// from one thread is never interleaved with another thread's output.
+// Formatting uses the line's own stream: manipulators last until the end of
+// the line and never touch std::cout, so each line sets the format it needs.
+class Line {
+public:
+  explicit Line(Level level);
+  ~Line();
+  Line(const Line&) = delete;
+  Line& operator=(const Line&) = delete;
+
+  // False when the message would be dropped; skip expensive formatting
+  explicit operator bool() const { return active_; }
+
+  template <typename T>
+  Line& operator<<(const T& value) {
+    if (active_) out_ << value;
+    return *this;
+  }
+
+  // std::endl, std::fixed and friends
+  Line& operator<<(std::ostream& (*manip)(std::ostream&)) {
+    if (active_) out_ << manip;
+    return *this;
+  }
+
+private:
+  Level level_;
+  bool active_;
+  std::ostringstream out_;
+};
+
+// Structured record, written as a JSON line in Json format only.
+// Text format ignores events; callers print their prose with Line instead.
+class Event {
+public:
+  explicit Event(const char* name, Level level = Level::Info);
+  ~Event();
+  Event(const Event&) = delete;
+  Event& operator=(const Event&) = delete;
+
+  explicit operator bool() const { return active_; }
+
+  Event& field(const char* key, double value);
+  Event& field(const char* key, int64_t value);
+  Event& field(const char* key, int value) { return field(key, static_cast<int64_t>(value)); }
+  Event& field(const char* key, size_t value) { return field(key, static_cast<int64_t>(value)); }
+  Event& field(const char* key, bool value);
+  Event& field(const char* key, const std::string& value);
+  Event& field(const char* key, const char* value) { return field(key, std::string(value)); }
+  Event& field(const char* key, const std::vector<double>& values);
+
+private:
+  Level level_;
+  bool active_;
+  std::string json_;
+};
+
+// Implementation detail of enabled()
+extern std::atomic<int> g_level;
+
+inline bool enabled(Level message_level) {
+  return static_cast<int>(message_level) >= g_level.load(std::memory_order_relaxed);
+}
+
+}  // namespace Log
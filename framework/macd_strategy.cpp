@@ -1,9 +1,10 @@
 #include "strategy.h"
+#include "indicators.h"
+#include "log.h"
 #include <vector>
 #include <iostream>
 #include <string>
 #include <algorithm>
-#include <numeric>
 #include <cmath>
 
 // MACD Momentum Strategy Implementation
@@ -14,6 +15,11 @@ public:
       : fast_period_(fast_period), slow_period_(slow_period), signal_period_(signal_period),
         overbought_level_(overbought_level), oversold_level_(oversold_level),
         fee_(fee), symbol_(std::move(symbol)) {
+    fast_window_.reset(fast_period_);
+    slow_window_.reset(slow_period_);
+    fast_ema_.reset(fast_period_);
+    slow_ema_.reset(slow_period_);
+    signal_window_.reset(signal_period_);
 
     // Configure risk management for momentum strategy
     risk_config_.max_portfolio_risk = 0.025;  // 2.5% max risk per trade (momentum can be more volatile)
@@ -46,9 +52,16 @@ public:
   }
 
   void on_start() override {
-    closes_.clear();
-    ema_fast_.clear();
-    ema_slow_.clear();
+    bar_count_ = 0;
+    current_close_ = 0.0;
+    fast_window_.reset();
+    slow_window_.reset();
+    fast_ema_.reset();
+    slow_ema_.reset();
+    ema_count_ = 0;
+    signal_window_.reset();
+    volatility_.reset();
+    trade_stats_.reset();
     macd_line_.clear();
     signal_line_.clear();
     histogram_.clear();
@@ -66,7 +79,7 @@ public:
     last_date_ = 0;
 
     trades_.clear();
-    daily_returns_.clear();
+    return_stats_.reset();
 
     position_ = 0;
     stop_loss_price_ = 0.0;
@@ -80,11 +93,16 @@ public:
 
   void on_bar(const Bar& b) override {
     double current_price = b.close;
-    closes_.push_back(current_price);
+    ++bar_count_;
+    current_close_ = current_price;
+    fast_window_.update(current_price);
+    slow_window_.update(current_price);
+    volatility_.update(current_price);
 
     // Need minimum data for MACD calculation
-    if (closes_.size() < static_cast<size_t>(slow_period_ + signal_period_)) {
+    if (bar_count_ < static_cast<size_t>(slow_period_ + signal_period_)) {
       update_position_value(current_price);
+      record_equity(b.date);  // Flat during warm-up, so the curve lines up with the bars
       return;
     }
 
@@ -102,6 +120,7 @@ public:
 
     // Update performance metrics
     update_performance_metrics();
+    record_equity(b.date);
   }
 
   void on_finish() override {
@@ -114,7 +133,7 @@ public:
     portfolio_value_ = cash_;
 
     calculate_final_metrics();
-    print_results();
+    if (report_) print_results();
   }
 
   double calculate_position_size(const Bar& bar, double portfolio_value) override {
@@ -139,7 +158,7 @@ public:
   }
 
   bool should_enter_position(const Bar& bar) override {
-    if (closes_.size() < static_cast<size_t>(slow_period_ + signal_period_)) {
+    if (bar_count_ < static_cast<size_t>(slow_period_ + signal_period_)) {
       return false;
     }
 
@@ -190,17 +209,10 @@ public:
   }
 
   double get_sharpe_ratio() const override {
-    if (daily_returns_.size() < 2) return 0.0;
+    if (return_stats_.count() < 2) return 0.0;
 
-    double mean_return = std::accumulate(daily_returns_.begin(), daily_returns_.end(), 0.0) / daily_returns_.size();
-
-    double variance = 0.0;
-    for (double ret : daily_returns_) {
-      variance += (ret - mean_return) * (ret - mean_return);
-    }
-    variance /= (daily_returns_.size() - 1);
-
-    double std_dev = std::sqrt(variance);
+    double mean_return = return_stats_.mean();
+    double std_dev = return_stats_.stddev();
     if (std_dev == 0.0) return 0.0;
 
     double risk_free_rate = 0.02;
@@ -242,25 +254,19 @@ public:
 
 private:
   void calculate_macd() {
-    size_t size = closes_.size();
-
     // Calculate EMAs
     calculate_emas();
 
     // Calculate MACD line (fast EMA - slow EMA)
-    if (ema_fast_.size() >= static_cast<size_t>(slow_period_)) {
-      macd_ = ema_fast_.back() - ema_slow_.back();
+    if (ema_count_ >= static_cast<size_t>(slow_period_)) {
+      macd_ = fast_ema_.value() - slow_ema_.value();
       macd_line_.push_back(macd_);
+      signal_window_.update(macd_);
     }
 
-    // Calculate signal line (EMA of MACD line)
-    if (macd_line_.size() >= static_cast<size_t>(signal_period_)) {
-      size_t start_idx = macd_line_.size() - signal_period_;
-      double sum = 0.0;
-      for (size_t i = start_idx; i < macd_line_.size(); ++i) {
-        sum += macd_line_[i];
-      }
-      signal_ = sum / signal_period_;
+    // Calculate signal line (average of the last signal_period MACD values)
+    if (signal_window_.ready()) {
+      signal_ = signal_window_.value();
       signal_line_.push_back(signal_);
     }
 
@@ -272,48 +278,28 @@ private:
   }
 
   void calculate_emas() {
-    size_t size = closes_.size();
-
-    // Calculate fast EMA
-    if (ema_fast_.empty()) {
-      // First EMA is just the price
-      if (size >= static_cast<size_t>(fast_period_)) {
-        double sum = 0.0;
-        for (size_t i = size - fast_period_; i < size; ++i) {
-          sum += closes_[i];
-        }
-        ema_fast_.push_back(sum / fast_period_);
-      }
+    // First EMA is seeded with the average of the most recent window;
+    // subsequent EMAs use smoothing. Windows are maintained in on_bar.
+    if (!fast_ema_.ready()) {
+      fast_ema_.seed(fast_window_.value());
     } else {
-      // Subsequent EMAs use smoothing
-      double multiplier = 2.0 / (fast_period_ + 1.0);
-      double ema = (closes_.back() * multiplier) + (ema_fast_.back() * (1.0 - multiplier));
-      ema_fast_.push_back(ema);
+      fast_ema_.update(current_close_);
     }
 
-    // Calculate slow EMA
-    if (ema_slow_.empty()) {
-      // First EMA is just the price
-      if (size >= static_cast<size_t>(slow_period_)) {
-        double sum = 0.0;
-        for (size_t i = size - slow_period_; i < size; ++i) {
-          sum += closes_[i];
-        }
-        ema_slow_.push_back(sum / slow_period_);
-      }
+    if (!slow_ema_.ready()) {
+      slow_ema_.seed(slow_window_.value());
     } else {
-      // Subsequent EMAs use smoothing
-      double multiplier = 2.0 / (slow_period_ + 1.0);
-      double ema = (closes_.back() * multiplier) + (ema_slow_.back() * (1.0 - multiplier));
-      ema_slow_.push_back(ema);
+      slow_ema_.update(current_close_);
     }
+
+    ++ema_count_;
   }
 
   int generate_signal() {
     if (histogram_.size() < 2) return 0;
 
     double current_hist = histogram_.back();
-    double previous_hist = histogram_[histogram_.size() - 2];
+    double previous_hist = histogram_.from_back(1);
 
     // Bullish signal: MACD crosses above signal line
     if (previous_hist <= 0.0 && current_hist > 0.0) {
@@ -441,6 +427,7 @@ private:
     exit_trade.symbol = symbol_;
 
     trades_.push_back(exit_trade);
+    trade_stats_.record(net_pnl);
 
     current_position_.quantity = 0.0;
     current_position_.avg_entry_price = 0.0;
@@ -499,7 +486,7 @@ private:
 
     if (previous_value_ > 0.0) {
       double daily_return = (portfolio_value_ - previous_value_) / previous_value_;
-      daily_returns_.push_back(daily_return);
+      return_stats_.update(daily_return);
     }
     previous_value_ = portfolio_value_;
   }
@@ -528,24 +515,10 @@ private:
   }
 
   double calculate_volatility_adjustment() {
-    if (closes_.size() < 20) return 1.0;
-
-    std::vector<double> returns;
-    for (size_t i = 1; i < closes_.size(); ++i) {
-      double ret = (closes_[i] - closes_[i-1]) / closes_[i-1];
-      returns.push_back(ret);
-    }
-
-    if (returns.size() < 2) return 1.0;
-
-    double mean_return = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    double variance = 0.0;
-    for (double ret : returns) {
-      variance += (ret - mean_return) * (ret - mean_return);
-    }
-    variance /= (returns.size() - 1);
+    if (bar_count_ < 20) return 1.0;
+    if (volatility_.return_count() < 2) return 1.0;
 
-    double volatility = std::sqrt(variance);
+    double volatility = volatility_.stddev();
     double target_volatility = 0.02;
     double current_volatility = std::max(volatility, 0.001);
 
@@ -555,92 +528,61 @@ private:
   }
 
   double calculate_win_rate() const {
-    int completed_trades = 0;
-    int winning_trades = 0;
-
-    for (const auto& trade : trades_) {
-      if (trade.type != Trade::Type::EXIT) continue;
-      ++completed_trades;
-      if (trade.pnl > 0.0) {
-        ++winning_trades;
-      }
-    }
-
-    if (completed_trades == 0) return 0.0;
-    return static_cast<double>(winning_trades) / completed_trades;
+    return trade_stats_.win_rate();
   }
 
   double calculate_avg_win() const {
-    double total_wins = 0.0;
-    int win_count = 0;
-
-    for (const auto& trade : trades_) {
-      if (trade.type != Trade::Type::EXIT) continue;
-      if (trade.pnl > 0.0) {
-        total_wins += trade.pnl;
-        win_count++;
-      }
-    }
-
-    return win_count > 0 ? total_wins / win_count : 0.0;
+    return trade_stats_.avg_win();
   }
 
   double calculate_avg_loss() const {
-    double total_losses = 0.0;
-    int loss_count = 0;
-
-    for (const auto& trade : trades_) {
-      if (trade.type != Trade::Type::EXIT) continue;
-      if (trade.pnl < 0.0) {
-        total_losses += trade.pnl;
-        loss_count++;
-      }
-    }
-
-    return loss_count > 0 ? total_losses / loss_count : 0.0;
+    return trade_stats_.avg_loss();
   }
 
   void print_results() {
-    std::cout << "\n" << std::string(60, '=') << std::endl;
-    std::cout << "MACD MOMENTUM STRATEGY RESULTS" << std::endl;
-    std::cout << std::string(60, '=') << std::endl;
-    std::cout << "Symbol: " << symbol_ << std::endl;
-    std::cout << "Parameters: Fast=" << fast_period_ << ", Slow=" << slow_period_
+    Log::Line out(Log::Level::Info);
+    if (!out) return;
+
+    out << "\n" << std::string(60, '=') << std::endl;
+    out << "MACD MOMENTUM STRATEGY RESULTS" << std::endl;
+    out << std::string(60, '=') << std::endl;
+    out << "Symbol: " << symbol_ << std::endl;
+    out << "Parameters: Fast=" << fast_period_ << ", Slow=" << slow_period_
               << ", Signal=" << signal_period_ << ", Overbought=" << overbought_level_
               << ", Oversold=" << oversold_level_ << ", Fee=" << fee_ << std::endl;
 
-    std::cout << "\nPERFORMANCE METRICS:" << std::endl;
-    std::cout << "  Total Return: " << (final_total_return_ * 100.0) << "%" << std::endl;
-    std::cout << "  Sharpe Ratio: " << final_sharpe_ratio_ << std::endl;
-    std::cout << "  Max Drawdown: " << (final_max_drawdown_ * 100.0) << "%" << std::endl;
-    std::cout << "  Total Trades: " << get_trade_count() << std::endl;
+    out << "\nPERFORMANCE METRICS:" << std::endl;
+    out << "  Total Return: " << (final_total_return_ * 100.0) << "%" << std::endl;
+    out << "  Sharpe Ratio: " << final_sharpe_ratio_ << std::endl;
+    out << "  Max Drawdown: " << (final_max_drawdown_ * 100.0) << "%" << std::endl;
+    out << "  Total Trades: " << get_trade_count() << std::endl;
 
     if (get_trade_count() > 0) {
-      std::cout << "  Win Rate: " << (calculate_win_rate() * 100.0) << "%" << std::endl;
-      std::cout << "  Avg Win: $" << calculate_avg_win() << std::endl;
-      std::cout << "  Avg Loss: $" << calculate_avg_loss() << std::endl;
+      out << "  Win Rate: " << (calculate_win_rate() * 100.0) << "%" << std::endl;
+      out << "  Avg Win: $" << calculate_avg_win() << std::endl;
+      out << "  Avg Loss: $" << calculate_avg_loss() << std::endl;
 
-      std::cout << "  Total Fees: $" << fees_paid_ << std::endl;
+      out << "  Total Fees: $" << fees_paid_ << std::endl;
     }
 
-    std::cout << "\nMACD STATISTICS:" << std::endl;
+    out << "\nMACD STATISTICS:" << std::endl;
     if (!macd_line_.empty()) {
-      std::cout << "  Current MACD: " << macd_ << std::endl;
-      std::cout << "  Current Signal: " << signal_ << std::endl;
+      out << "  Current MACD: " << macd_ << std::endl;
+      out << "  Current Signal: " << signal_ << std::endl;
       if (!histogram_.empty()) {
-        std::cout << "  Current Histogram: " << histogram_.back() << std::endl;
+        out << "  Current Histogram: " << histogram_.back() << std::endl;
       } else {
-        std::cout << "  Current Histogram: n/a" << std::endl;
+        out << "  Current Histogram: n/a" << std::endl;
       }
     }
 
-    std::cout << "\nRISK METRICS:" << std::endl;
-    std::cout << "  Portfolio Value: $" << portfolio_value_ << std::endl;
-    std::cout << "  Risk per Trade: " << (risk_config_.max_portfolio_risk * 100.0) << "%" << std::endl;
-    std::cout << "  Stop Loss: " << (risk_config_.stop_loss_pct * 100.0) << "%" << std::endl;
-    std::cout << "  Take Profit: " << (risk_config_.take_profit_pct * 100.0) << "%" << std::endl;
+    out << "\nRISK METRICS:" << std::endl;
+    out << "  Portfolio Value: $" << portfolio_value_ << std::endl;
+    out << "  Risk per Trade: " << (risk_config_.max_portfolio_risk * 100.0) << "%" << std::endl;
+    out << "  Stop Loss: " << (risk_config_.stop_loss_pct * 100.0) << "%" << std::endl;
+    out << "  Take Profit: " << (risk_config_.take_profit_pct * 100.0) << "%" << std::endl;
 
-    std::cout << std::string(60, '=') << std::endl;
+    out << std::string(60, '=') << std::endl;
   }
 
   // Strategy parameters
@@ -652,13 +594,20 @@ private:
   double fee_;
   std::string symbol_;
 
-  // Price data
-  std::vector<double> closes_;
-  std::vector<double> ema_fast_;
-  std::vector<double> ema_slow_;
-  std::vector<double> macd_line_;
-  std::vector<double> signal_line_;
-  std::vector<double> histogram_;
+  // Incremental indicators (O(1) per bar)
+  size_t bar_count_ = 0;
+  double current_close_ = 0.0;
+  Indicators::RunningSma fast_window_;
+  Indicators::RunningSma slow_window_;
+  Indicators::Ema fast_ema_;
+  Indicators::Ema slow_ema_;
+  size_t ema_count_ = 0;
+  Indicators::RunningSma signal_window_;
+  Indicators::ReturnVolatility volatility_;
+  Indicators::TradeStats trade_stats_;
+  RingBuffer<double> macd_line_{1};   // Only the latest MACD/signal are read back
+  RingBuffer<double> signal_line_{1};
+  RingBuffer<double> histogram_{2};   // Crossover test needs the previous bar too
   double macd_ = 0.0;
   double signal_ = 0.0;
 
@@ -679,7 +628,7 @@ private:
   // Performance tracking
   double peak_portfolio_value_ = 0.0;
   double max_drawdown_ = 0.0;
-  std::vector<double> daily_returns_;
+  Indicators::WelfordStats return_stats_;  // Per-bar portfolio returns
 
   // Final metrics
   double final_sharpe_ratio_ = 0.0;
@@ -0,0 +1,217 @@
+#pragma once
+
+#include "bar_series.h"
+#include "strategy.h"
+#include "thread_pool.h"
+#include "rand32m.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Monte-Carlo permutation test over Bar series.
+//
+// The algorithm programs (MCPT_TRN, MCPT_BARS, ...) each carry their own
+// permute/optimise loop over raw price arrays. This is the same test for
+// anything that can score a Bar series:
+//
+//   Mcpt::Result r = Mcpt::run(bars, Mcpt::OhlcPermuter(), optimizer, options);
+//
+// Replication 0 scores the original bars; every other replication scores a
+// permutation drawn from its own stream rand32m_stream(seed, irep), so the
+// result depends on the seed and not on the thread count. Replications run
+// on a WorkStealingPool, and each worker reuses one preallocated Bar buffer
+// and permuter scratch for all of its replications.
+//
+// A Permuter provides
+//   using Scratch = ...;                                  per-worker state
+//   void prepare(BarSpan original);                       once, before the run
+//   void permute(BarSpan original, std::vector<Bar>& out,
+//                Scratch& scratch, RAND32M_STATE* rng) const;
+// where `out` arrives holding a copy of the original bars (dates, timestamps
+// and volume are never touched) and the prices of a previous permutation.
+//
+// An Optimizer is called as optimize(BarSpan bars, int irep, unsigned worker)
+// and returns the best in-sample score it can find on those bars. It is
+// called concurrently from several workers.
+namespace Mcpt {
+
+struct Options {
+  int nreps = 100;              // Replications, including the unpermuted one
+  int num_threads = 1;          // 0 = all cores
+  uint64_t seed = 123456789;    // Base of the per-replication streams
+};
+
+struct Result {
+  std::vector<double> scores;   // scores[0] is the original bars
+  int count = 0;                // Replications scoring >= the original (including it)
+  double p_value = 1.0;         // count / nreps
+};
+
+namespace detail {
+
+// Fisher-Yates over x[0..n), as do_permute in the algorithm programs
+inline void shuffle(double* x, int n, RAND32M_STATE* rng) {
+  int i = n;
+  while (i > 1) {
+    int j = static_cast<int>(unifrand_r(rng) * i);
+    if (j >= i) j = i - 1;  // Should never happen, but be safe
+    --i;
+    std::swap(x[i], x[j]);
+  }
+}
+
+inline double checked_log(double price) {
+  if (!(price > 0.0)) throw std::invalid_argument("Mcpt: prices must be positive");
+  return std::log(price);
+}
+
+}  // namespace detail
+
+// Shuffles close-to-close log changes after bar `start`, as MCPT_TRN does.
+// Only closes are permuted: the permuted bars have open = high = low = close.
+// The first and last closes keep their original values.
+class ClosePermuter {
+public:
+  using Scratch = std::vector<double>;
+
+  explicit ClosePermuter(size_t start = 0) : start_(start) {}
+
+  void prepare(BarSpan original) {
+    changes_.clear();
+    if (original.size() < start_ + 2) return;
+    for (size_t i = start_ + 1; i < original.size(); ++i) {
+      changes_.push_back(detail::checked_log(original[i].close) - detail::checked_log(original[i - 1].close));
+    }
+  }
+
+  void permute(BarSpan original, std::vector<Bar>& out, Scratch& scratch, RAND32M_STATE* rng) const {
+    if (changes_.empty()) return;
+    scratch.assign(changes_.begin(), changes_.end());
+    detail::shuffle(scratch.data(), static_cast<int>(scratch.size()), rng);
+
+    double log_close = std::log(original[start_].close);
+    for (size_t k = 0; k < scratch.size(); ++k) {
+      log_close += scratch[k];
+      Bar& bar = out[start_ + 1 + k];
+      bar.open = bar.high = bar.low = bar.close = std::exp(log_close);
+    }
+  }
+
+private:
+  size_t start_;
+  std::vector<double> changes_;
+};
+
+// Shuffles bar-relative log changes after bar `start`, as do_permute in
+// MCPT_BARS: the close-to-open gaps are shuffled as one set, and the
+// (high, low, close) offsets from each bar's open as another, so every
+// permuted bar is a valid OHLC bar. With preserve_oo the first gap and the
+// last bar are kept, preserving the end-to-end open-to-open change for
+// next-open-to-open scoring.
+class OhlcPermuter {
+public:
+  using Scratch = std::vector<double>;
+
+  explicit OhlcPermuter(size_t start = 0, bool preserve_oo = true)
+      : start_(start), preserve_oo_(preserve_oo ? 1 : 0) {}
+
+  void prepare(BarSpan original) {
+    nrel_ = original.size() > start_ + 1 ? original.size() - start_ - 1 : 0;
+    rel_.assign(4 * nrel_, 0.0);
+    for (size_t k = 0; k < nrel_; ++k) {
+      const Bar& prev = original[start_ + k];
+      const Bar& bar = original[start_ + k + 1];
+      double log_open = detail::checked_log(bar.open);
+      rel_[k] = log_open - detail::checked_log(prev.close);
+      rel_[nrel_ + k] = detail::checked_log(bar.high) - log_open;
+      rel_[2 * nrel_ + k] = detail::checked_log(bar.low) - log_open;
+      rel_[3 * nrel_ + k] = detail::checked_log(bar.close) - log_open;
+    }
+  }
+
+  void permute(BarSpan original, std::vector<Bar>& out, Scratch& scratch, RAND32M_STATE* rng) const {
+    if (nrel_ < 2) return;
+    scratch.assign(rel_.begin(), rel_.end());
+    double* rel_open = scratch.data();
+    double* rel_high = rel_open + nrel_;
+    double* rel_low = rel_high + nrel_;
+    double* rel_close = rel_low + nrel_;
+    const int p = preserve_oo_;
+
+    // Close-to-open gaps
+    detail::shuffle(rel_open + p, static_cast<int>(nrel_) - p, rng);
+
+    // Open-to-(high, low, close) offsets move together
+    int i = static_cast<int>(nrel_) - p;
+    while (i > 1) {
+      int j = static_cast<int>(unifrand_r(rng) * i);
+      if (j >= i) j = i - 1;
+      --i;
+      std::swap(rel_high[i], rel_high[j]);
+      std::swap(rel_low[i], rel_low[j]);
+      std::swap(rel_close[i], rel_close[j]);
+    }
+
+    double log_close = std::log(original[start_].close);
+    for (size_t k = 0; k < nrel_; ++k) {
+      double log_open = log_close + rel_open[k];
+      log_close = log_open + rel_close[k];
+      Bar& bar = out[start_ + 1 + k];
+      bar.open = std::exp(log_open);
+      bar.high = std::exp(log_open + rel_high[k]);
+      bar.low = std::exp(log_open + rel_low[k]);
+      bar.close = std::exp(log_close);
+    }
+  }
+
+private:
+  size_t start_;
+  int preserve_oo_;
+  size_t nrel_ = 0;
+  std::vector<double> rel_;  // rel_open, rel_high, rel_low, rel_close
+};
+
+template <class Permuter, class Optimizer>
+Result run(BarSpan original, Permuter permuter, Optimizer&& optimize, const Options& options) {
+  if (options.nreps < 1) throw std::invalid_argument("Mcpt::run: nreps must be at least 1");
+  permuter.prepare(original);
+
+  struct Workspace {
+    std::vector<Bar> bars;
+    typename Permuter::Scratch scratch;
+  };
+
+  WorkStealingPool pool(options.num_threads);
+  std::vector<Workspace> workspaces(pool.size());
+  for (Workspace& ws : workspaces) ws.bars.assign(original.begin(), original.end());
+
+  Result result;
+  result.scores.assign(static_cast<size_t>(options.nreps), 0.0);
+
+  pool.parallel_for(static_cast<size_t>(options.nreps), [&](size_t index, unsigned worker) {
+    const int irep = static_cast<int>(index);
+    if (irep == 0) {
+      result.scores[0] = optimize(original, 0, worker);
+      return;
+    }
+
+    Workspace& ws = workspaces[worker];
+    RAND32M_STATE rng;
+    rand32m_stream(&rng, options.seed, static_cast<uint64_t>(irep));
+    permuter.permute(original, ws.bars, ws.scratch, &rng);
+    result.scores[index] = optimize(BarSpan(ws.bars), irep, worker);
+  });
+
+  result.count = 1;
+  for (int irep = 1; irep < options.nreps; ++irep) {
+    if (result.scores[irep] >= result.scores[0]) ++result.count;
+  }
+  result.p_value = static_cast<double>(result.count) / options.nreps;
+  return result;
+}
+
+}  // namespace Mcpt
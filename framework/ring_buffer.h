@@ -0,0 +1,56 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+// Fixed-capacity FIFO that overwrites its oldest element when full.
+// Used for strategy history so per-instance memory is O(lookback), not O(bars).
+template <typename T>
+class RingBuffer {
+public:
+  explicit RingBuffer(size_t capacity = 1) { reset(capacity); }
+
+  // Change capacity; drops all contents
+  void reset(size_t capacity) {
+    buffer_.assign(std::max<size_t>(1, capacity), T());
+    clear();
+  }
+
+  void clear() {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  void push_back(const T& value) {
+    buffer_[head_] = value;
+    head_ = (head_ + 1) % buffer_.size();
+    if (size_ < buffer_.size()) ++size_;
+  }
+
+  size_t size() const { return size_; }
+  size_t capacity() const { return buffer_.size(); }
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ == buffer_.size(); }
+
+  // i = 0 is the oldest retained element
+  const T& operator[](size_t i) const {
+    return buffer_[(head_ + buffer_.size() - size_ + i) % buffer_.size()];
+  }
+
+  // i = 0 is the newest element
+  const T& from_back(size_t i) const {
+    return buffer_[(head_ + buffer_.size() - 1 - i) % buffer_.size()];
+  }
+
+  const T& front() const { return (*this)[0]; }
+  const T& back() const { return from_back(0); }
+
+  // Element that the next push_back() will overwrite (only meaningful when full)
+  const T& oldest() const { return buffer_[head_]; }
+
+private:
+  std::vector<T> buffer_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+};
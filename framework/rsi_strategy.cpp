@@ -1,9 +1,10 @@
 #include "strategy.h"
+#include "indicators.h"
+#include "log.h"
 #include <vector>
 #include <iostream>
 #include <string>
 #include <algorithm>
-#include <numeric>
 #include <cmath>
 
 // RSI Mean Reversion Strategy Implementation
@@ -13,6 +14,8 @@ public:
                            int confirmation_period, double fee, std::string symbol)
       : rsi_period_(rsi_period), overbought_level_(overbought_level), oversold_level_(oversold_level),
         confirmation_period_(confirmation_period), fee_(fee), symbol_(std::move(symbol)) {
+    rsi_indicator_.reset(rsi_period_);
+    rsi_history_.reset(static_cast<size_t>(std::max(1, confirmation_period_)));
 
     // Configure risk management for mean reversion
     risk_config_.max_portfolio_risk = 0.015;  // 1.5% max risk per trade (conservative for mean reversion)
@@ -45,10 +48,13 @@ public:
   }
 
   void on_start() override {
-    closes_.clear();
-    gains_.clear();
-    losses_.clear();
-    rsi_values_.clear();
+    bar_count_ = 0;
+    rsi_indicator_.reset();
+    volatility_.reset();
+    trade_stats_.reset();
+    rsi_history_.clear();
+    rsi_sum_ = 0.0;
+    rsi_count_ = 0;
 
     current_position_ = {};
     current_position_.symbol = symbol_;
@@ -63,7 +69,7 @@ public:
     last_date_ = 0;
 
     trades_.clear();
-    daily_returns_.clear();
+    return_stats_.reset();
 
     position_ = 0;
     stop_loss_price_ = 0.0;
@@ -76,11 +82,14 @@ public:
 
   void on_bar(const Bar& b) override {
     double current_price = b.close;
-    closes_.push_back(current_price);
+    ++bar_count_;
+    rsi_indicator_.update(current_price);
+    volatility_.update(current_price);
 
     // Need minimum data for RSI calculation
-    if (closes_.size() < static_cast<size_t>(rsi_period_ + 1)) {
+    if (!rsi_indicator_.ready()) {
       update_position_value(current_price);
+      record_equity(b.date);  // Flat during warm-up, so the curve lines up with the bars
       return;
     }
 
@@ -98,6 +107,7 @@ public:
 
     // Update performance metrics
     update_performance_metrics();
+    record_equity(b.date);
   }
 
   void on_finish() override {
@@ -110,7 +120,7 @@ public:
     portfolio_value_ = cash_;
 
     calculate_final_metrics();
-    print_results();
+    if (report_) print_results();
   }
 
   double calculate_position_size(const Bar& bar, double portfolio_value) override {
@@ -135,7 +145,7 @@ public:
   }
 
   bool should_enter_position(const Bar& bar) override {
-    if (closes_.size() < static_cast<size_t>(rsi_period_ + confirmation_period_)) {
+    if (bar_count_ < static_cast<size_t>(rsi_period_ + confirmation_period_)) {
       return false;
     }
 
@@ -186,17 +196,10 @@ public:
   }
 
   double get_sharpe_ratio() const override {
-    if (daily_returns_.size() < 2) return 0.0;
+    if (return_stats_.count() < 2) return 0.0;
 
-    double mean_return = std::accumulate(daily_returns_.begin(), daily_returns_.end(), 0.0) / daily_returns_.size();
-
-    double variance = 0.0;
-    for (double ret : daily_returns_) {
-      variance += (ret - mean_return) * (ret - mean_return);
-    }
-    variance /= (daily_returns_.size() - 1);
-
-    double std_dev = std::sqrt(variance);
+    double mean_return = return_stats_.mean();
+    double std_dev = return_stats_.stddev();
     if (std_dev == 0.0) return 0.0;
 
     double risk_free_rate = 0.02;
@@ -238,67 +241,15 @@ public:
 
 private:
   void calculate_rsi() {
-    size_t size = closes_.size();
-
-    if (size < 2) return;
-
-    // Calculate price changes
-    std::vector<double> price_changes;
-    for (size_t i = 1; i < size; ++i) {
-      price_changes.push_back(closes_[i] - closes_[i-1]);
-    }
-
-    // Calculate gains and losses
-    double avg_gain = 0.0;
-    double avg_loss = 0.0;
-
-    if (gains_.size() < static_cast<size_t>(rsi_period_)) {
-      // Initial calculation - simple average
-      double sum_gains = 0.0;
-      double sum_losses = 0.0;
-      int count_gains = 0;
-      int count_losses = 0;
-
-      for (size_t i = std::max(1UL, size - static_cast<size_t>(rsi_period_)); i < size; ++i) {
-        double change = closes_[i] - closes_[i-1];
-        if (change > 0) {
-          sum_gains += change;
-          count_gains++;
-        } else {
-          sum_losses += std::abs(change);
-          count_losses++;
-        }
-      }
-
-      avg_gain = count_gains > 0 ? sum_gains / count_gains : 0.0;
-      avg_loss = count_losses > 0 ? sum_losses / count_losses : 0.0;
-    } else {
-      // Wilder's smoothing
-      double change = price_changes.back();
-      double gain = change > 0 ? change : 0.0;
-      double loss = change < 0 ? std::abs(change) : 0.0;
-
-      avg_gain = (gains_.back() * (rsi_period_ - 1) + gain) / rsi_period_;
-      avg_loss = (losses_.back() * (rsi_period_ - 1) + loss) / rsi_period_;
-    }
-
-    // Store for next calculation
-    gains_.push_back(avg_gain);
-    losses_.push_back(avg_loss);
-
-    // Calculate RSI
-    if (avg_loss > 0.0) {
-      double rs = avg_gain / avg_loss;
-      rsi_ = 100.0 - (100.0 / (1.0 + rs));
-    } else {
-      rsi_ = 100.0;  // All gains, no losses
-    }
-
-    rsi_values_.push_back(rsi_);
+    // Wilder averages are updated once per bar in on_bar
+    rsi_ = rsi_indicator_.value();
+    rsi_history_.push_back(rsi_);
+    rsi_sum_ += rsi_;
+    ++rsi_count_;
   }
 
   int generate_signal() {
-    if (rsi_values_.size() < static_cast<size_t>(confirmation_period_)) {
+    if (rsi_history_.size() < static_cast<size_t>(confirmation_period_)) {
       return 0;
     }
 
@@ -306,9 +257,9 @@ private:
     if (rsi_ >= overbought_level_) {
       // Confirm with multiple periods
       int overbought_count = 0;
-      size_t start_idx = rsi_values_.size() - confirmation_period_;
-      for (size_t i = start_idx; i < rsi_values_.size(); ++i) {
-        if (rsi_values_[i] >= overbought_level_) overbought_count++;
+      size_t start_idx = rsi_history_.size() - confirmation_period_;
+      for (size_t i = start_idx; i < rsi_history_.size(); ++i) {
+        if (rsi_history_[i] >= overbought_level_) overbought_count++;
       }
 
       if (overbought_count >= confirmation_period_ / 2) {
@@ -320,9 +271,9 @@ private:
     if (rsi_ <= oversold_level_) {
       // Confirm with multiple periods
       int oversold_count = 0;
-      size_t start_idx = rsi_values_.size() - confirmation_period_;
-      for (size_t i = start_idx; i < rsi_values_.size(); ++i) {
-        if (rsi_values_[i] <= oversold_level_) oversold_count++;
+      size_t start_idx = rsi_history_.size() - confirmation_period_;
+      for (size_t i = start_idx; i < rsi_history_.size(); ++i) {
+        if (rsi_history_[i] <= oversold_level_) oversold_count++;
       }
 
       if (oversold_count >= confirmation_period_ / 2) {
@@ -441,6 +392,7 @@ private:
     exit_trade.symbol = symbol_;
 
     trades_.push_back(exit_trade);
+    trade_stats_.record(net_pnl);
 
     // Reset position
     current_position_.quantity = 0.0;
@@ -501,7 +453,7 @@ private:
 
     if (previous_value_ > 0.0) {
       double daily_return = (portfolio_value_ - previous_value_) / previous_value_;
-      daily_returns_.push_back(daily_return);
+      return_stats_.update(daily_return);
     }
     previous_value_ = portfolio_value_;
   }
@@ -530,24 +482,10 @@ private:
   }
 
   double calculate_volatility_adjustment() {
-    if (closes_.size() < 20) return 1.0;
+    if (bar_count_ < 20) return 1.0;
+    if (volatility_.return_count() < 2) return 1.0;
 
-    std::vector<double> returns;
-    for (size_t i = 1; i < closes_.size(); ++i) {
-      double ret = (closes_[i] - closes_[i-1]) / closes_[i-1];
-      returns.push_back(ret);
-    }
-
-    if (returns.size() < 2) return 1.0;
-
-    double mean_return = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-    double variance = 0.0;
-    for (double ret : returns) {
-      variance += (ret - mean_return) * (ret - mean_return);
-    }
-    variance /= (returns.size() - 1);
-
-    double volatility = std::sqrt(variance);
+    double volatility = volatility_.stddev();
     double target_volatility = 0.02;
     double current_volatility = std::max(volatility, 0.001);
 
@@ -557,90 +495,59 @@ private:
   }
 
   double calculate_win_rate() const {
-    int completed_trades = 0;
-    int winning_trades = 0;
-
-    for (const auto& trade : trades_) {
-      if (trade.type != Trade::Type::EXIT) continue;
-      ++completed_trades;
-      if (trade.pnl > 0.0) {
-        ++winning_trades;
-      }
-    }
-
-    if (completed_trades == 0) return 0.0;
-    return static_cast<double>(winning_trades) / completed_trades;
+    return trade_stats_.win_rate();
   }
 
   double calculate_avg_win() const {
-    double total_wins = 0.0;
-    int win_count = 0;
-
-    for (const auto& trade : trades_) {
-      if (trade.type != Trade::Type::EXIT) continue;
-      if (trade.pnl > 0.0) {
-        total_wins += trade.pnl;
-        win_count++;
-      }
-    }
-
-    return win_count > 0 ? total_wins / win_count : 0.0;
+    return trade_stats_.avg_win();
   }
 
   double calculate_avg_loss() const {
-    double total_losses = 0.0;
-    int loss_count = 0;
-
-    for (const auto& trade : trades_) {
-      if (trade.type != Trade::Type::EXIT) continue;
-      if (trade.pnl < 0.0) {
-        total_losses += trade.pnl;
-        loss_count++;
-      }
-    }
-
-    return loss_count > 0 ? total_losses / loss_count : 0.0;
+    return trade_stats_.avg_loss();
   }
 
   void print_results() {
-    std::cout << "\n" << std::string(60, '=') << std::endl;
-    std::cout << "RSI MEAN REVERSION STRATEGY RESULTS" << std::endl;
-    std::cout << std::string(60, '=') << std::endl;
-    std::cout << "Symbol: " << symbol_ << std::endl;
-    std::cout << "Parameters: RSI Period=" << rsi_period_
+    Log::Line out(Log::Level::Info);
+    if (!out) return;
+
+    out << "\n" << std::string(60, '=') << std::endl;
+    out << "RSI MEAN REVERSION STRATEGY RESULTS" << std::endl;
+    out << std::string(60, '=') << std::endl;
+    out << "Symbol: " << symbol_ << std::endl;
+    out << "Parameters: RSI Period=" << rsi_period_
               << ", Overbought=" << overbought_level_
               << ", Oversold=" << oversold_level_
               << ", Confirmation=" << confirmation_period_
               << ", Fee=" << fee_ << std::endl;
 
-    std::cout << "\nPERFORMANCE METRICS:" << std::endl;
-    std::cout << "  Total Return: " << (final_total_return_ * 100.0) << "%" << std::endl;
-    std::cout << "  Sharpe Ratio: " << final_sharpe_ratio_ << std::endl;
-    std::cout << "  Max Drawdown: " << (final_max_drawdown_ * 100.0) << "%" << std::endl;
-    std::cout << "  Total Trades: " << get_trade_count() << std::endl;
+    out << "\nPERFORMANCE METRICS:" << std::endl;
+    out << "  Total Return: " << (final_total_return_ * 100.0) << "%" << std::endl;
+    out << "  Sharpe Ratio: " << final_sharpe_ratio_ << std::endl;
+    out << "  Max Drawdown: " << (final_max_drawdown_ * 100.0) << "%" << std::endl;
+    out << "  Total Trades: " << get_trade_count() << std::endl;
 
     if (get_trade_count() > 0) {
-      std::cout << "  Win Rate: " << (calculate_win_rate() * 100.0) << "%" << std::endl;
-      std::cout << "  Avg Win: $" << calculate_avg_win() << std::endl;
-      std::cout << "  Avg Loss: $" << calculate_avg_loss() << std::endl;
+      out << "  Win Rate: " << (calculate_win_rate() * 100.0) << "%" << std::endl;
+      out << "  Avg Win: $" << calculate_avg_win() << std::endl;
+      out << "  Avg Loss: $" << calculate_avg_loss() << std::endl;
 
-      std::cout << "  Total Fees: $" << fees_paid_ << std::endl;
+      out << "  Total Fees: $" << fees_paid_ << std::endl;
     }
 
-    std::cout << "\nRSI STATISTICS:" << std::endl;
-    if (!rsi_values_.empty()) {
-      double avg_rsi = std::accumulate(rsi_values_.begin(), rsi_values_.end(), 0.0) / rsi_values_.size();
-      std::cout << "  Average RSI: " << avg_rsi << std::endl;
-      std::cout << "  Current RSI: " << rsi_ << std::endl;
+    out << "\nRSI STATISTICS:" << std::endl;
+    if (rsi_count_ > 0) {
+      double avg_rsi = rsi_sum_ / static_cast<double>(rsi_count_);
+      out << "  Average RSI: " << avg_rsi << std::endl;
+      out << "  Current RSI: " << rsi_ << std::endl;
     }
 
-    std::cout << "\nRISK METRICS:" << std::endl;
-    std::cout << "  Portfolio Value: $" << portfolio_value_ << std::endl;
-    std::cout << "  Risk per Trade: " << (risk_config_.max_portfolio_risk * 100.0) << "%" << std::endl;
-    std::cout << "  Stop Loss: " << (risk_config_.stop_loss_pct * 100.0) << "%" << std::endl;
-    std::cout << "  Take Profit: " << (risk_config_.take_profit_pct * 100.0) << "%" << std::endl;
+    out << "\nRISK METRICS:" << std::endl;
+    out << "  Portfolio Value: $" << portfolio_value_ << std::endl;
+    out << "  Risk per Trade: " << (risk_config_.max_portfolio_risk * 100.0) << "%" << std::endl;
+    out << "  Stop Loss: " << (risk_config_.stop_loss_pct * 100.0) << "%" << std::endl;
+    out << "  Take Profit: " << (risk_config_.take_profit_pct * 100.0) << "%" << std::endl;
 
-    std::cout << std::string(60, '=') << std::endl;
+    out << std::string(60, '=') << std::endl;
   }
 
   // Strategy parameters
@@ -651,11 +558,14 @@ private:
   double fee_;
   std::string symbol_;
 
-  // Price data
-  std::vector<double> closes_;
-  std::vector<double> gains_;
-  std::vector<double> losses_;
-  std::vector<double> rsi_values_;
+  // Incremental indicators (O(1) per bar)
+  size_t bar_count_ = 0;
+  Indicators::WilderRsi rsi_indicator_;
+  Indicators::ReturnVolatility volatility_;
+  Indicators::TradeStats trade_stats_;
+  RingBuffer<double> rsi_history_;  // Last confirmation_period_ RSI readings
+  double rsi_sum_ = 0.0;            // Running totals for the average RSI report
+  size_t rsi_count_ = 0;
   double rsi_ = 50.0;
 
   // Position management
@@ -675,7 +585,7 @@ private:
   // Performance tracking
   double peak_portfolio_value_ = 0.0;
   double max_drawdown_ = 0.0;
-  std::vector<double> daily_returns_;
+  Indicators::WelfordStats return_stats_;  // Per-bar portfolio returns
 
   // Final metrics
   double final_sharpe_ratio_ = 0.0;
@@ -1,3 +1,4 @@
+#include "bar_loader.h"
 #include "strategy.h"
 #include "strategy_factory.h"
 
@@ -19,6 +20,7 @@ static void usage() {
             << "    sma  --short N --long M --fee F --symbol TICKER\n"
             << "    rsi  --period N --overbought X --oversold Y --confirm K --fee F --symbol TICKER\n"
             << "    macd --fast N --slow M --signal K --overbought X --oversold Y --fee F --symbol TICKER\n";
+  std::cout << "  --equity-out FILE  write the bar-by-bar equity curve (date equity)\n";
   std::cout << "  Format: YYYYMMDD Open High Low Close [Volume]\n";
 }
 
@@ -29,57 +31,6 @@ static std::string to_upper(std::string value) {
   return value;
 }
 
-static bool parse_ohlc_line(const std::string& line, Bar& out) {
-  if (line.length() < 8) return false;
-
-  size_t pos = 0;
-  std::string date_str = line.substr(0, 8);
-  for (char c : date_str) {
-    if (c < '0' || c > '9') return false;
-  }
-  out.date = std::stoi(date_str);
-
-  pos = 8;
-  auto skip_delim = [&]() {
-    while (pos < line.length() && (line[pos] == ' ' || line[pos] == '\t' || line[pos] == ',')) ++pos;
-  };
-
-  skip_delim();
-  if (pos >= line.length()) return false;
-  size_t end_pos;
-  out.open = std::stod(line.substr(pos), &end_pos);
-  pos += end_pos;
-
-  skip_delim();
-  if (pos >= line.length()) return false;
-  out.high = std::stod(line.substr(pos), &end_pos);
-  pos += end_pos;
-
-  skip_delim();
-  if (pos >= line.length()) return false;
-  out.low = std::stod(line.substr(pos), &end_pos);
-  pos += end_pos;
-
-  skip_delim();
-  if (pos >= line.length()) return false;
-  out.close = std::stod(line.substr(pos), &end_pos);
-  pos += end_pos;
-
-  skip_delim();
-  if (pos < line.length()) {
-    out.volume = std::stod(line.substr(pos), &end_pos);
-  } else {
-    out.volume = 0.0;
-  }
-
-  if (!std::isfinite(out.open) || !std::isfinite(out.high) ||
-      !std::isfinite(out.low) || !std::isfinite(out.close)) {
-    return false;
-  }
-
-  return true;
-}
-
 int main(int argc, char** argv) {
   if (argc < 3) {
     usage();
@@ -93,6 +44,7 @@ int main(int argc, char** argv) {
   // Shared defaults
   double fee = 0.0005;
   std::string symbol = "DEMO";
+  std::string equity_out;
 
   // SMA defaults
   int sma_short = 10;
@@ -121,7 +73,10 @@ int main(int argc, char** argv) {
 
   for (int i = 3; i < argc; ++i) {
     std::string arg = argv[i];
-    if (arg == "--symbol") {
+    if (arg == "--equity-out") {
+      require_value(arg, i);
+      equity_out = argv[++i];
+    } else if (arg == "--symbol") {
       require_value(arg, i);
       symbol = argv[++i];
     } else if (arg == "--fee") {
@@ -211,37 +166,29 @@ int main(int argc, char** argv) {
     return 1;
   }
 
-  std::ifstream file(filename);
-  if (!file.is_open()) {
-    std::cout << "Cannot open file: " << filename << std::endl;
-    return 1;
-  }
-
   std::cout << "Starting " << strategy->get_name() << " with " << symbol << std::endl;
   std::cout << "File: " << filename << std::endl;
 
-  strategy->on_start();
-
-  std::string line;
-  int line_count = 0;
-  int valid_bars = 0;
+  // Full equity history is only kept when asked for
+  EquityRecorder equity;
+  if (!equity_out.empty()) {
+    strategy->set_equity_recorder(&equity);
+  }
 
-  while (std::getline(file, line)) {
-    ++line_count;
-    if (line.length() < 2) continue;
+  strategy->on_start();
 
-    Bar bar;
-    if (parse_ohlc_line(line, bar)) {
-      ++valid_bars;
-      strategy->on_bar(bar);
-    } else {
-      std::cout << "Warning: Skipping invalid line " << line_count << std::endl;
-    }
+  BarLoader::LoadStats load_stats;
+  bool opened = BarLoader::for_each_bar(
+      filename,
+      [&](const Bar& bar) { strategy->on_bar(bar); },
+      [](size_t line_number) { std::cout << "Warning: Skipping invalid line " << line_number << std::endl; },
+      &load_stats);
+  if (!opened) {
+    std::cout << "Cannot open file: " << filename << std::endl;
+    return 1;
   }
 
-  file.close();
-
-  std::cout << "Processed " << line_count << " lines, " << valid_bars << " valid bars" << std::endl;
+  std::cout << "Processed " << load_stats.line_count << " lines, " << load_stats.valid_bars << " valid bars" << std::endl;
 
   strategy->on_finish();
 
@@ -253,5 +200,19 @@ int main(int argc, char** argv) {
   std::cout << "Max Drawdown: " << (strategy->get_max_drawdown() * 100.0) << "%" << std::endl;
   std::cout << "Total Trades: " << strategy->get_trade_count() << std::endl;
 
+  if (!equity_out.empty()) {
+    std::ofstream out(equity_out);
+    if (!out.is_open()) {
+      std::cout << "Cannot write equity curve: " << equity_out << std::endl;
+      return 1;
+    }
+    out.setf(std::ios::fixed);
+    out.precision(2);
+    for (size_t i = 0; i < equity.size(); ++i) {
+      out << equity.dates[i] << ' ' << equity.equity[i] << '\n';
+    }
+    std::cout << "Equity curve: " << equity.size() << " points written to " << equity_out << std::endl;
+  }
+
   return 0;
 }
@@ -1,10 +1,11 @@
 #include "strategy.h"
+#include "indicators.h"
+#include "log.h"
 #include <vector>
 #include <cstdio>
 #include <cmath>
 #include <string>
 #include <algorithm>
-#include <numeric>
 #include <iostream>
 
 // Enhanced SMA Crossover Strategy with Risk Management
@@ -14,6 +15,8 @@ public:
       : sw_(short_win), lw_(long_win), fee_(fee), symbol_(std::move(symbol)) {
     if (sw_ < 1) sw_ = 1;
     if (lw_ < sw_) lw_ = sw_;
+    short_window_.reset(sw_);
+    long_window_.reset(lw_);
 
     // Configure advanced risk management
     risk_config_.max_portfolio_risk = 0.02;      // 2% max risk per trade
@@ -46,7 +49,12 @@ public:
   }
 
   void on_start() override {
-    closes_.clear();
+    bar_count_ = 0;
+    short_window_.reset();
+    long_window_.reset();
+    atr_.reset(static_cast<int>(risk_config_.atr_period));
+    volatility_.reset();
+    trade_stats_.reset();
     current_position_ = {};
     current_position_.symbol = symbol_;
 
@@ -60,7 +68,7 @@ public:
     last_date_ = 0;
 
     trades_.clear();
-    daily_returns_.clear();
+    return_stats_.reset();
 
     short_sma_ = 0.0;
     long_sma_ = 0.0;
@@ -73,11 +81,16 @@ public:
 
   void on_bar(const Bar& b) override {
     double current_price = b.close;
-    closes_.push_back(current_price);
+    ++bar_count_;
+    short_window_.update(current_price);
+    long_window_.update(current_price);
+    atr_.update(b.high, b.low, current_price);
+    volatility_.update(current_price);
 
     // Need enough data for both SMAs
-    if (closes_.size() < static_cast<size_t>(lw_)) {
+    if (bar_count_ < static_cast<size_t>(lw_)) {
       update_position_value(current_price);
+      record_equity(b.date);  // Flat during warm-up, so the curve lines up with the bars
       return;
     }
 
@@ -95,6 +108,7 @@ public:
 
     // Update performance metrics
     update_performance_metrics();
+    record_equity(b.date);
   }
 
   void on_finish() override {
@@ -111,7 +125,7 @@ public:
     calculate_final_metrics();
 
     // Print comprehensive results
-    print_results();
+    if (report_) print_results();
   }
 
   double calculate_position_size(const Bar& bar, double portfolio_value) override {
@@ -156,28 +170,12 @@ public:
   }
 
   double calculate_volatility_adjustment() {
-    if (closes_.size() < 20) return 1.0;  // Not enough data
+    if (bar_count_ < 20) return 1.0;  // Not enough data
 
-    // Calculate historical volatility (standard deviation of returns)
-    std::vector<double> returns;
-    for (size_t i = 1; i < closes_.size(); ++i) {
-      double ret = (closes_[i] - closes_[i-1]) / closes_[i-1];
-      returns.push_back(ret);
-    }
-
-    if (returns.size() < 2) return 1.0;
-
-    // Calculate mean return
-    double mean_return = std::accumulate(returns.begin(), returns.end(), 0.0) / returns.size();
-
-    // Calculate variance
-    double variance = 0.0;
-    for (double ret : returns) {
-      variance += (ret - mean_return) * (ret - mean_return);
-    }
-    variance /= (returns.size() - 1);
+    // Historical volatility (standard deviation of returns), maintained incrementally
+    if (volatility_.return_count() < 2) return 1.0;
 
-    double volatility = std::sqrt(variance);
+    double volatility = volatility_.stddev();
 
     // Target volatility of 2% (adjust based on your risk tolerance)
     double target_volatility = 0.02;
@@ -191,48 +189,26 @@ public:
   }
 
   double calculate_atr_stop_loss(const Bar& bar, double entry_price) {
-    if (!risk_config_.enable_atr_stops || closes_.size() < static_cast<size_t>(risk_config_.atr_period)) {
+    if (!risk_config_.enable_atr_stops || !atr_.ready()) {
       return entry_price * (1.0 - risk_config_.stop_loss_pct);
     }
 
-    double atr = calculate_atr(risk_config_.atr_period);
+    double atr = atr_.value();
     return entry_price - (atr * risk_config_.atr_multiplier);
   }
 
   double calculate_atr_take_profit(const Bar& bar, double entry_price) {
-    if (!risk_config_.enable_atr_stops || closes_.size() < static_cast<size_t>(risk_config_.atr_period)) {
+    if (!risk_config_.enable_atr_stops || !atr_.ready()) {
       return entry_price * (1.0 + risk_config_.take_profit_pct);
     }
 
-    double atr = calculate_atr(risk_config_.atr_period);
+    double atr = atr_.value();
     // Use 3:1 reward/risk ratio with ATR
     double risk_amount = atr * risk_config_.atr_multiplier;
     double reward_amount = risk_amount * 3.0;
     return entry_price + reward_amount;
   }
 
-  double calculate_atr(int period) {
-    if (closes_.size() < static_cast<size_t>(period + 1)) return 0.0;
-
-    std::vector<double> true_ranges;
-    for (size_t i = 1; i < closes_.size(); ++i) {
-      double high = 0.0, low = 0.0;  // Simplified - using close prices for now
-      double tr = std::abs(closes_[i] - closes_[i-1]);
-      true_ranges.push_back(tr);
-    }
-
-    if (true_ranges.size() < static_cast<size_t>(period)) return 0.0;
-
-    // Calculate ATR as SMA of true ranges
-    double atr_sum = 0.0;
-    int start_idx = true_ranges.size() - period;
-    for (int i = start_idx; i < static_cast<int>(true_ranges.size()); ++i) {
-      atr_sum += true_ranges[i];
-    }
-
-    return atr_sum / period;
-  }
-
   bool check_drawdown_breaker() {
     if (!risk_config_.enable_drawdown_breaker) return false;
 
@@ -253,7 +229,7 @@ public:
   }
 
   bool should_enter_position(const Bar& bar) override {
-    if (closes_.size() < static_cast<size_t>(lw_)) return false;
+    if (bar_count_ < static_cast<size_t>(lw_)) return false;
 
     calculate_smas();
     return generate_signal() != 0;
@@ -302,17 +278,10 @@ public:
   }
 
   double get_sharpe_ratio() const override {
-    if (daily_returns_.size() < 2) return 0.0;
-
-    double mean_return = std::accumulate(daily_returns_.begin(), daily_returns_.end(), 0.0) / daily_returns_.size();
+    if (return_stats_.count() < 2) return 0.0;
 
-    double variance = 0.0;
-    for (double ret : daily_returns_) {
-      variance += (ret - mean_return) * (ret - mean_return);
-    }
-    variance /= (daily_returns_.size() - 1);
-
-    double std_dev = std::sqrt(variance);
+    double mean_return = return_stats_.mean();
+    double std_dev = return_stats_.stddev();
     if (std_dev == 0.0) return 0.0;
 
     // Assume risk-free rate of 2%
@@ -355,24 +324,12 @@ public:
 
 private:
   void calculate_smas() {
-    size_t size = closes_.size();
-
-    // Calculate short SMA
-    if (size >= static_cast<size_t>(sw_)) {
-      double sum = 0.0;
-      for (int i = 0; i < sw_; ++i) {
-        sum += closes_[size - 1 - i];
-      }
-      short_sma_ = sum / sw_;
+    // Both windows are maintained incrementally in on_bar
+    if (short_window_.ready()) {
+      short_sma_ = short_window_.value();
     }
-
-    // Calculate long SMA
-    if (size >= static_cast<size_t>(lw_)) {
-      double sum = 0.0;
-      for (int i = 0; i < lw_; ++i) {
-        sum += closes_[size - 1 - i];
-      }
-      long_sma_ = sum / lw_;
+    if (long_window_.ready()) {
+      long_sma_ = long_window_.value();
     }
   }
 
@@ -491,6 +448,7 @@ private:
     exit_trade.symbol = symbol_;
 
     trades_.push_back(exit_trade);
+    trade_stats_.record(net_pnl);
 
     current_position_.quantity = 0.0;
     current_position_.avg_entry_price = 0.0;
@@ -549,7 +507,7 @@ private:
 
     if (previous_value_ > 0.0) {
       double daily_return = (portfolio_value_ - previous_value_) / previous_value_;
-      daily_returns_.push_back(daily_return);
+      return_stats_.update(daily_return);
     }
     previous_value_ = portfolio_value_;
   }
@@ -562,78 +520,47 @@ private:
   }
 
   double calculate_win_rate() const {
-    int completed_trades = 0;
-    int winning_trades = 0;
-
-    for (const auto& trade : trades_) {
-      if (trade.type != Trade::Type::EXIT) continue;
-      ++completed_trades;
-      if (trade.pnl > 0.0) {
-        ++winning_trades;
-      }
-    }
-
-    if (completed_trades == 0) return 0.0;
-    return static_cast<double>(winning_trades) / completed_trades;
+    return trade_stats_.win_rate();
   }
 
   double calculate_avg_win() const {
-    double total_wins = 0.0;
-    int win_count = 0;
-
-    for (const auto& trade : trades_) {
-      if (trade.type != Trade::Type::EXIT) continue;
-      if (trade.pnl > 0.0) {
-        total_wins += trade.pnl;
-        ++win_count;
-      }
-    }
-
-    return win_count > 0 ? total_wins / win_count : 0.0;
+    return trade_stats_.avg_win();
   }
 
   double calculate_avg_loss() const {
-    double total_losses = 0.0;
-    int loss_count = 0;
-
-    for (const auto& trade : trades_) {
-      if (trade.type != Trade::Type::EXIT) continue;
-      if (trade.pnl < 0.0) {
-        total_losses += trade.pnl;
-        ++loss_count;
-      }
-    }
-
-    return loss_count > 0 ? total_losses / loss_count : 0.0;
+    return trade_stats_.avg_loss();
   }
 
   void print_results() {
-    std::cout << "\n" << std::string(60, '=') << std::endl;
-    std::cout << "SMA CROSSOVER STRATEGY RESULTS" << std::endl;
-    std::cout << std::string(60, '=') << std::endl;
-    std::cout << "Symbol: " << symbol_ << std::endl;
-    std::cout << "Parameters: Short=" << sw_ << ", Long=" << lw_ << ", Fee=" << fee_ << std::endl;
-    std::cout << "\nPERFORMANCE METRICS:" << std::endl;
-    std::cout << "  Total Return: " << (final_total_return_ * 100.0) << "%" << std::endl;
-    std::cout << "  Sharpe Ratio: " << final_sharpe_ratio_ << std::endl;
-    std::cout << "  Max Drawdown: " << (final_max_drawdown_ * 100.0) << "%" << std::endl;
-    std::cout << "  Total Trades: " << get_trade_count() << std::endl;
+    Log::Line out(Log::Level::Info);
+    if (!out) return;
+
+    out << "\n" << std::string(60, '=') << std::endl;
+    out << "SMA CROSSOVER STRATEGY RESULTS" << std::endl;
+    out << std::string(60, '=') << std::endl;
+    out << "Symbol: " << symbol_ << std::endl;
+    out << "Parameters: Short=" << sw_ << ", Long=" << lw_ << ", Fee=" << fee_ << std::endl;
+    out << "\nPERFORMANCE METRICS:" << std::endl;
+    out << "  Total Return: " << (final_total_return_ * 100.0) << "%" << std::endl;
+    out << "  Sharpe Ratio: " << final_sharpe_ratio_ << std::endl;
+    out << "  Max Drawdown: " << (final_max_drawdown_ * 100.0) << "%" << std::endl;
+    out << "  Total Trades: " << get_trade_count() << std::endl;
 
     if (get_trade_count() > 0) {
-      std::cout << "  Win Rate: " << (calculate_win_rate() * 100.0) << "%" << std::endl;
-      std::cout << "  Avg Win: $" << calculate_avg_win() << std::endl;
-      std::cout << "  Avg Loss: $" << calculate_avg_loss() << std::endl;
+      out << "  Win Rate: " << (calculate_win_rate() * 100.0) << "%" << std::endl;
+      out << "  Avg Win: $" << calculate_avg_win() << std::endl;
+      out << "  Avg Loss: $" << calculate_avg_loss() << std::endl;
 
-      std::cout << "  Total Fees: $" << fees_paid_ << std::endl;
+      out << "  Total Fees: $" << fees_paid_ << std::endl;
     }
 
-    std::cout << "\nRISK METRICS:" << std::endl;
-    std::cout << "  Portfolio Value: $" << portfolio_value_ << std::endl;
-    std::cout << "  Risk per Trade: " << (risk_config_.max_portfolio_risk * 100.0) << "%" << std::endl;
-    std::cout << "  Stop Loss: " << (risk_config_.stop_loss_pct * 100.0) << "%" << std::endl;
-    std::cout << "  Take Profit: " << (risk_config_.take_profit_pct * 100.0) << "%" << std::endl;
+    out << "\nRISK METRICS:" << std::endl;
+    out << "  Portfolio Value: $" << portfolio_value_ << std::endl;
+    out << "  Risk per Trade: " << (risk_config_.max_portfolio_risk * 100.0) << "%" << std::endl;
+    out << "  Stop Loss: " << (risk_config_.stop_loss_pct * 100.0) << "%" << std::endl;
+    out << "  Take Profit: " << (risk_config_.take_profit_pct * 100.0) << "%" << std::endl;
 
-    std::cout << std::string(60, '=') << std::endl;
+    out << std::string(60, '=') << std::endl;
   }
 
   // Strategy parameters
@@ -641,8 +568,13 @@ private:
   double fee_;
   std::string symbol_;
 
-  // Price data
-  std::vector<double> closes_;
+  // Incremental indicators (O(1) per bar)
+  size_t bar_count_ = 0;
+  Indicators::RunningSma short_window_;
+  Indicators::RunningSma long_window_;
+  Indicators::RunningAtr atr_;
+  Indicators::ReturnVolatility volatility_;
+  Indicators::TradeStats trade_stats_;
   double short_sma_ = 0.0;
   double long_sma_ = 0.0;
 
@@ -663,7 +595,7 @@ private:
   // Performance tracking
   double peak_portfolio_value_ = 0.0;
   double max_drawdown_ = 0.0;
-  std::vector<double> daily_returns_;
+  Indicators::WelfordStats return_stats_;  // Per-bar portfolio returns
 
   // Final metrics
   double final_sharpe_ratio_ = 0.0;
@@ -1,13 +1,15 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <memory>
 
 // Enhanced Bar structure with volume support
 struct Bar {
-  int date = 0;         // YYYYMMDD (optional; 0 if missing)
+  int date = 0;           // YYYYMMDD (optional; 0 if missing)
+  int64_t timestamp = 0;  // Epoch milliseconds, UTC (0 if missing; see bar_timestamp())
   double open = 0.0;
   double high = 0.0;
   double low = 0.0;
@@ -60,6 +62,30 @@ struct RiskConfig {
   double recovery_mode_risk = 0.005;     // 0.5% risk in recovery mode
 };
 
+// Opt-in full equity curve. Strategies keep only bounded history themselves;
+// attach one of these when the bar-by-bar portfolio value is needed.
+struct EquityRecorder {
+  std::vector<int> dates;
+  std::vector<double> equity;
+
+  void reserve(size_t n) {
+    dates.reserve(n);
+    equity.reserve(n);
+  }
+
+  void record(int date, double value) {
+    dates.push_back(date);
+    equity.push_back(value);
+  }
+
+  void clear() {
+    dates.clear();
+    equity.clear();
+  }
+
+  size_t size() const { return equity.size(); }
+};
+
 // Enhanced Strategy interface with risk management
 class Strategy {
 public:
@@ -95,9 +121,21 @@ public:
   virtual std::vector<Trade> get_trades() const { return {}; }
   virtual std::vector<Position> get_positions() const { return {}; }
 
+  // Equity curve capture (not owned; nullptr disables recording)
+  void set_equity_recorder(EquityRecorder* recorder) { equity_recorder_ = recorder; }
+
+  // Whether on_finish prints the results block (off for MCPT replications)
+  void set_report(bool report) { report_ = report; }
+
 protected:
+  void record_equity(int date) {
+    if (equity_recorder_) equity_recorder_->record(date, portfolio_value_);
+  }
+
   std::vector<Trade> trades_;
   std::vector<Position> positions_;
   double portfolio_value_ = 100000.0;  // Default $100k portfolio
   RiskConfig risk_config_;
+  EquityRecorder* equity_recorder_ = nullptr;
+  bool report_ = true;
 };
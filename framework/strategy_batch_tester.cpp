@@ -1,83 +1,104 @@
 #include "strategy_tester.h"
+#include "strategy_mcpt.h"
+#include "bar_loader.h"
 #include "strategy.h"
+#include "log.h"
+#include <iomanip>
 #include <iostream>
 #include <fstream>
-#include <sstream>
 #include <vector>
 #include <string>
 #include <algorithm>
 #include <random>
+#include <cstdint>
+#include <cstdlib>
 
 // Data loading function
 std::vector<Bar> load_market_data(const std::string& filename) {
   std::vector<Bar> bars;
-  std::ifstream file(filename);
 
-  if (!file.is_open()) {
-    std::cout << "Error: Cannot open data file: " << filename << std::endl;
+  if (!BarLoader::load_bars(filename, bars)) {
+    Log::Line(Log::Level::Error) << "Error: Cannot open data file: " << filename << std::endl;
     return bars;
   }
 
-  std::string line;
-  int line_count = 0;
-
-  while (std::getline(file, line)) {
-    ++line_count;
-    if (line.length() < 2) continue;
-
-    // Simple parser for OHLC data
-    std::istringstream iss(line);
-    Bar bar;
-
-    // Parse date (first 8 characters)
-    std::string date_str;
-    if (!(iss >> date_str)) continue;
-
-    try {
-      bar.date = std::stoi(date_str.substr(0, 8));
-    } catch (const std::exception&) {
-      continue;  // Skip invalid lines
-    }
-
-    // Parse OHLC prices
-    if (!(iss >> bar.open >> bar.high >> bar.low >> bar.close)) {
-      continue;  // Skip if we can't parse all required fields
-    }
-
-    // Optional volume
-    if (iss >> bar.volume) {
-      // Volume provided
-    } else {
-      bar.volume = 0.0;  // Default volume
-    }
+  Log::Line(Log::Level::Info) << "Loaded " << bars.size() << " bars from " << filename << std::endl;
+  return bars;
+}
 
-    bars.push_back(bar);
+// Permutation test of the whole configuration set: how often does the best
+// configuration on shuffled bars do at least as well as on the real ones?
+void run_strategy_mcpt(StrategyTester& tester,
+                       const std::vector<StrategyTestConfig>& configs,
+                       const BarSeries& data,
+                       const Mcpt::Options& options) {
+  Log::Line(Log::Level::Info) << "\nRunning " << options.nreps << " MCPT replications of "
+                              << configs.size() << " configurations (seed " << options.seed << ")..." << std::endl;
+
+  Mcpt::StrategyResult result;
+  try {
+    result = Mcpt::run_strategy_tester(tester, configs, data, Mcpt::OhlcPermuter(), options);
+  } catch (const std::exception& e) {
+    Log::Line(Log::Level::Error) << "Error: MCPT failed: " << e.what() << std::endl;
+    return;
   }
 
-  file.close();
+  const auto& mcpt = result.mcpt;
+  for (size_t irep = 0; irep < mcpt.scores.size(); ++irep) {
+    Log::Line(Log::Level::Debug) << "Replication " << irep << ": best return " << (mcpt.scores[irep] * 100.0)
+                                 << "% (config " << (result.best_config[irep] + 1) << ")" << std::endl;
+  }
 
-  std::cout << "Loaded " << bars.size() << " bars from " << filename << std::endl;
-  return bars;
+  Log::Line(Log::Level::Info) << "\nBest configuration on the original bars: " << result.original_best.strategy_name
+                              << " return " << (mcpt.scores[0] * 100.0) << "%" << std::endl;
+  tester.print_strategy_metrics(result.original_best);
+  Log::Line(Log::Level::Info) << "MCPT p-value (" << mcpt.count << " of " << mcpt.scores.size()
+                              << " replications at least as good): " << mcpt.p_value << std::endl;
+
+  Log::Event("mcpt")
+      .field("replications", mcpt.scores.size())
+      .field("seed", static_cast<int64_t>(options.seed))
+      .field("original_return", mcpt.scores[0])
+      .field("count", mcpt.count)
+      .field("p_value", mcpt.p_value)
+      .field("best_params", result.original_best.parameters);
 }
 
 // Main batch testing function
 void run_strategy_batch_test(const std::string& data_file,
                              int num_strategies = 50,
-                             const std::string& strategy_type_input = "SMA") {
-  std::cout << "\n" << std::string(100, '*') << std::endl;
-  std::cout << "SYSTEMATIC STRATEGY GENERATION & TESTING" << std::endl;
-  std::cout << std::string(100, '*') << std::endl;
+                             const std::string& strategy_type_input = "SMA",
+                             int num_threads = 1,
+                             int mcpt_reps = 0,
+                             uint64_t seed = 123456789,
+                             int first_date = 0,
+                             int last_date = 0) {
+  Log::Line(Log::Level::Info) << "\n" << std::string(100, '*') << std::endl;
+  Log::Line(Log::Level::Info) << "SYSTEMATIC STRATEGY GENERATION & TESTING" << std::endl;
+  Log::Line(Log::Level::Info) << std::string(100, '*') << std::endl;
 
   // Load market data
-  std::cout << "Loading market data..." << std::endl;
-  std::vector<Bar> data = load_market_data(data_file);
+  Log::Line(Log::Level::Info) << "Loading market data..." << std::endl;
+  // Loaded once; every StrategyMetrics shares this buffer
+  BarSeries data(load_market_data(data_file));
 
   if (data.empty()) {
-    std::cout << "Error: No data loaded. Exiting." << std::endl;
+    Log::Line(Log::Level::Error) << "Error: No data loaded. Exiting." << std::endl;
     return;
   }
 
-  std::cout << "Data loaded: " << data.size() << " bars" << std::endl;
+  Log::Line(Log::Level::Info) << "Data loaded: " << data.size() << " bars" << std::endl;
+
+  // Restrict to whole calendar days [first_date, last_date]; a view, not a copy
+  if (first_date != 0) {
+    data = data.slice_dates(first_date, last_date);
+    if (data.empty()) {
+      Log::Line(Log::Level::Error) << "Error: No bars between " << first_date << " and " << last_date << std::endl;
+      return;
+    }
+    Log::Line(Log::Level::Info) << "Date range " << data.front().date << " to " << data.back().date << ": "
+                                << data.size() << " bars" << std::endl;
+  }
 
   std::string strategy_type = strategy_type_input;
   std::transform(strategy_type.begin(), strategy_type.end(), strategy_type.begin(), [](unsigned char c) {
@@ -86,34 +107,45 @@ void run_strategy_batch_test(const std::string& data_file,
 
   // Initialize strategy tester
   StrategyTester tester;
+  tester.set_num_threads(num_threads);
 
-  std::cout << "\nGenerating " << num_strategies << " " << strategy_type << " strategy configurations..." << std::endl;
+  Log::Line(Log::Level::Info) << "\nGenerating " << num_strategies << " " << strategy_type << " strategy configurations..." << std::endl;
 
+  // Config i comes from its own stream of `seed`, so the set is the same for every run and thread count
   std::vector<StrategyTestConfig> configs;
   if (strategy_type == "SMA") {
-    configs = StrategyGeneration::generate_sma_configs(num_strategies, 5, 50, 20, 200);
+    configs = StrategyGeneration::generate_sma_configs(num_strategies, 5, 50, 20, 200, seed);
   } else if (strategy_type == "RSI") {
-    configs = StrategyGeneration::generate_rsi_configs(num_strategies);
+    configs = StrategyGeneration::generate_rsi_configs(num_strategies, 7, 25, 65.0, 85.0, 15.0, 35.0, 1, 4, seed);
   } else if (strategy_type == "MACD") {
-    configs = StrategyGeneration::generate_macd_configs(num_strategies);
+    configs = StrategyGeneration::generate_macd_configs(num_strategies, 8, 15, 20, 35, 5, 12, 0.5, 1.5, -1.5, -0.5, seed);
   } else {
-    std::cout << "Unknown strategy type: " << strategy_type_input << std::endl;
+    Log::Line(Log::Level::Error) << "Unknown strategy type: " << strategy_type_input << std::endl;
     return;
   }
 
-  std::cout << "Generated " << configs.size() << " " << strategy_type << " strategy configurations" << std::endl;
+  Log::Line(Log::Level::Info) << "Generated " << configs.size() << " " << strategy_type << " strategy configurations" << std::endl;
+
+  if (mcpt_reps > 0) {
+    Mcpt::Options options;
+    options.nreps = mcpt_reps;
+    options.num_threads = num_threads;
+    options.seed = seed;
+    run_strategy_mcpt(tester, configs, data, options);
+    return;
+  }
 
   // Test all strategies
-  std::cout << "\nStarting batch testing..." << std::endl;
+  Log::Line(Log::Level::Info) << "\nStarting batch testing..." << std::endl;
   auto results = tester.test_multiple_strategies(configs, data);
 
   if (results.empty()) {
-    std::cout << "Error: No results generated." << std::endl;
+    Log::Line(Log::Level::Error) << "Error: No results generated." << std::endl;
     return;
   }
 
   // Select and display top strategies
-  std::cout << "\nSelecting top performing strategies..." << std::endl;
+  Log::Line(Log::Level::Info) << "\nSelecting top performing strategies..." << std::endl;
   auto top_strategies = tester.select_top_strategies(results, 10);
 
   // Save results to file
@@ -154,13 +186,13 @@ void run_strategy_batch_test(const std::string& data_file,
     }
 
     results_file.close();
-    std::cout << "Results saved to strategy_test_results.txt" << std::endl;
+    Log::Line(Log::Level::Info) << "Results saved to strategy_test_results.txt" << std::endl;
   }
 
   // Display summary
-  std::cout << "\n" << std::string(100, '=') << std::endl;
-  std::cout << "BATCH TESTING SUMMARY" << std::endl;
-  std::cout << std::string(100, '=') << std::endl;
+  Log::Line(Log::Level::Info) << "\n" << std::string(100, '=') << std::endl;
+  Log::Line(Log::Level::Info) << "BATCH TESTING SUMMARY" << std::endl;
+  Log::Line(Log::Level::Info) << std::string(100, '=') << std::endl;
 
   double best_return = top_strategies[0].total_return;
   double avg_return = 0.0;
@@ -174,15 +206,25 @@ void run_strategy_batch_test(const std::string& data_file,
   }
   avg_return /= results.size();
 
-  std::cout << "Best Strategy Return: " << (best_return * 100.0) << "%" << std::endl;
-  std::cout << "Average Strategy Return: " << (avg_return * 100.0) << "%" << std::endl;
-  std::cout << "Best Sharpe Ratio: " << best_sharpe << std::endl;
-  std::cout << "Total Trades Across All Strategies: " << total_trades << std::endl;
-  std::cout << "Strategies Tested: " << results.size() << std::endl;
-
-  std::cout << "\n✅ STRATEGY GENERATION & TESTING COMPLETE!" << std::endl;
-  std::cout << "📊 Check 'strategy_test_results.txt' for detailed results" << std::endl;
-  std::cout << "🏆 Top strategies are ready for production use!" << std::endl;
+  Log::Line(Log::Level::Info) << "Best Strategy Return: " << std::fixed << std::setprecision(4) << (best_return * 100.0)
+                              << "%" << std::endl;
+  Log::Line(Log::Level::Info) << "Average Strategy Return: " << std::fixed << std::setprecision(4)
+                              << (avg_return * 100.0) << "%" << std::endl;
+  Log::Line(Log::Level::Info) << "Best Sharpe Ratio: " << std::fixed << std::setprecision(4) << best_sharpe << std::endl;
+  Log::Line(Log::Level::Info) << "Total Trades Across All Strategies: " << total_trades << std::endl;
+  Log::Line(Log::Level::Info) << "Strategies Tested: " << results.size() << std::endl;
+
+  Log::Event("summary")
+      .field("strategies", results.size())
+      .field("best_return", best_return)
+      .field("avg_return", avg_return)
+      .field("best_sharpe", best_sharpe)
+      .field("total_trades", total_trades)
+      .field("best_params", top_strategies[0].parameters);
+
+  Log::Line(Log::Level::Info) << "\n✅ STRATEGY GENERATION & TESTING COMPLETE!" << std::endl;
+  Log::Line(Log::Level::Info) << "📊 Check 'strategy_test_results.txt' for detailed results" << std::endl;
+  Log::Line(Log::Level::Info) << "🏆 Top strategies are ready for production use!" << std::endl;
 }
 
 // Interactive mode for custom testing
@@ -195,7 +237,7 @@ void run_interactive_mode() {
   std::getline(std::cin, data_file);
 
   // Load data
-  auto data = load_market_data(data_file);
+  BarSeries data(load_market_data(data_file));
   if (data.empty()) {
     std::cout << "No data loaded. Exiting." << std::endl;
     return;
@@ -260,11 +302,59 @@ void run_interactive_mode() {
 }
 
 int main(int argc, char** argv) {
-  // Seed random number generator
-  srand(static_cast<unsigned int>(time(nullptr)));
+  // Pull the options out of the argument list; the rest stays positional
+  int num_threads = 1;
+  int mcpt_reps = 0;
+  uint64_t seed = 123456789;
+  int first_date = 0, last_date = 0;
+  Log::Level log_level = Log::Level::Info;
+  bool json_log = false;
+  std::vector<char*> positional;
+  positional.push_back(argv[0]);
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "--threads" || arg == "--log-level" || arg == "--mcpt" || arg == "--seed") {
+      if (i + 1 >= argc) {
+        std::cout << "Missing value for option " << arg << std::endl;
+        return 1;
+      }
+      if (arg == "--threads") {
+        num_threads = std::atoi(argv[++i]);  // 0 = all cores
+      } else if (arg == "--mcpt") {
+        mcpt_reps = std::atoi(argv[++i]);
+      } else if (arg == "--seed") {
+        seed = std::strtoull(argv[++i], nullptr, 10);
+      } else if (!Log::parse_level(argv[++i], log_level)) {
+        std::cout << "Unknown log level: " << argv[i] << " (debug, info, warn, error, off)" << std::endl;
+        return 1;
+      }
+    } else if (arg == "--dates") {
+      if (i + 2 >= argc) {
+        std::cout << "--dates needs FIRST and LAST (YYYYMMDD)" << std::endl;
+        return 1;
+      }
+      first_date = std::atoi(argv[++i]);
+      last_date = std::atoi(argv[++i]);
+      if (first_date <= 0 || last_date < first_date) {
+        std::cout << "Invalid date range " << argv[i - 1] << " " << argv[i] << std::endl;
+        return 1;
+      }
+    } else if (arg == "--quiet") {
+      log_level = Log::Level::Warn;
+    } else if (arg == "--json") {
+      json_log = true;
+    } else {
+      positional.push_back(argv[i]);
+    }
+  }
+  argc = static_cast<int>(positional.size());
+  argv = positional.data();
+
+  Log::set_level(log_level);
+  Log::set_format(json_log ? Log::Format::Json : Log::Format::Text);
 
-  std::cout << "STRATEGY GENERATION & TESTING FRAMEWORK" << std::endl;
-  std::cout << "=======================================" << std::endl;
+  Log::Line(Log::Level::Info) << "STRATEGY GENERATION & TESTING FRAMEWORK" << std::endl;
+  Log::Line(Log::Level::Info) << "=======================================" << std::endl;
 
   if (argc >= 2) {
     // Command line mode
@@ -294,7 +384,11 @@ int main(int argc, char** argv) {
       }
     }
 
-    run_strategy_batch_test(data_file, num_strategies, strategy_type);
+    // Workers hand finished messages to a writer thread instead of the console
+    Log::set_sink(std::make_shared<Log::AsyncSink>(std::make_shared<Log::StreamSink>()));
+    run_strategy_batch_test(data_file, num_strategies, strategy_type, num_threads, mcpt_reps, seed,
+                            first_date, last_date);
+    Log::flush();
   } else {
     // Default mode - use market_data.txt if it exists
     std::string default_file = "market_data.txt";
@@ -302,11 +396,13 @@ int main(int argc, char** argv) {
     if (test_file.good()) {
       test_file.close();
       std::cout << "Using default data file: " << default_file << std::endl;
-      run_strategy_batch_test(default_file, 50);
+      run_strategy_batch_test(default_file, 50, "SMA", num_threads);
     } else {
       test_file.close();
       std::cout << "No data file provided and market_data.txt not found." << std::endl;
-      std::cout << "Usage: " << argv[0] << " <data_file> [num_strategies]" << std::endl;
+      std::cout << "Usage: " << argv[0] << " <data_file> [num_strategies] [strategy_type] [--threads N]"
+                << " [--dates FIRST LAST] [--quiet | --log-level LEVEL] [--json] [--seed S] [--mcpt NREPS]"
+                << std::endl;
       std::cout << "Starting interactive mode..." << std::endl;
       run_interactive_mode();
     }
@@ -51,6 +51,34 @@ std::unique_ptr<Strategy> StrategyFactory::create_strategy(
   return nullptr;
 }
 
+std::vector<double> StrategyFactory::canonical_parameters(
+    const std::string& strategy_name,
+    const std::vector<double>& parameters) {
+
+  // Must mirror the truncation in create_strategy above
+  auto canonical = [&](size_t count, std::initializer_list<size_t> integer_slots) {
+    std::vector<double> result(parameters.begin(), parameters.begin() + count);
+    for (size_t slot : integer_slots) {
+      result[slot] = static_cast<int>(result[slot]);
+    }
+    return result;
+  };
+
+  if (strategy_name == "SMA" && parameters.size() >= 3) {
+    return canonical(3, {0, 1});
+  }
+
+  if (strategy_name == "RSI" && parameters.size() >= 5) {
+    return canonical(5, {0, 3});
+  }
+
+  if (strategy_name == "MACD" && parameters.size() >= 6) {
+    return canonical(6, {0, 1, 2});
+  }
+
+  return parameters;
+}
+
 std::vector<std::string> StrategyFactory::get_available_strategies() {
   return {"SMA", "RSI", "MACD"};
 }
@@ -18,6 +18,14 @@ public:
       const std::vector<double>& parameters,
       const std::string& symbol = "DEMO");
 
+  // Parameters exactly as create_strategy consumes them: integer slots
+  // (windows, periods) truncated the same way and unused trailing values
+  // dropped. Configs with equal canonical parameters build identical
+  // strategies. Unknown strategies are returned unchanged.
+  static std::vector<double> canonical_parameters(
+      const std::string& strategy_name,
+      const std::vector<double>& parameters);
+
   // Get available strategy types
   static std::vector<std::string> get_available_strategies();
 
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "mcpt_engine.h"
+#include "strategy_tester.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+// In-process permutation test of StrategyTester optimisation.
+//
+// Each replication tests every configuration on the (permuted) bars and
+// scores the replication with the best value of `criterion`, so the p-value
+// accounts for the selection over the whole configuration set, as MCPT_TRN
+// does for its lookback grid. The original series is validated once; its
+// permutations keep the dates, order and OHLC shape and are not re-validated.
+// Replications print nothing; the caller reports the original result and the
+// p-value.
+namespace Mcpt {
+
+struct StrategyResult {
+  Result mcpt;
+  std::vector<size_t> best_config;   // Index into configs, per replication
+  StrategyMetrics original_best;     // Best configuration on the original bars
+};
+
+template <class Permuter>
+StrategyResult run_strategy_tester(StrategyTester& tester,
+                                   const std::vector<StrategyTestConfig>& configs,
+                                   const BarSeries& data,
+                                   Permuter permuter,
+                                   const Options& options,
+                                   double StrategyMetrics::*criterion = &StrategyMetrics::total_return) {
+  if (configs.empty()) throw std::invalid_argument("Mcpt::run_strategy_tester: no configurations");
+  StrategyTester::validate_dataset(data);  // Throws if the bars are unusable
+
+  StrategyResult out;
+  out.best_config.assign(static_cast<size_t>(options.nreps > 0 ? options.nreps : 0), 0);
+
+  auto optimize = [&](BarSpan bars, int irep, unsigned) {
+    double best = 0.0;
+    for (size_t i = 0; i < configs.size(); ++i) {
+      StrategyMetrics metrics = tester.test_strategy_unchecked(configs[i], bars);
+      double score = metrics.*criterion;
+      if (i == 0 || score > best) {
+        best = score;
+        out.best_config[irep] = i;
+        if (irep == 0) out.original_best = metrics;
+      }
+    }
+    return best;
+  };
+
+  out.mcpt = run(data.view(), permuter, optimize, options);
+  out.original_best.market_data = data;
+  return out;
+}
+
+}  // namespace Mcpt
@@ -1,4 +1,5 @@
 #include "strategy_registry.h"
+#include "strategy_factory.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -7,23 +8,57 @@
 #include <chrono>
 #include <fstream>
 #include <random>
+#include <cstring>
+#include <cstdlib>
+
+namespace {
+
+// Parse "[a,b,c]" as written by write_strategy_row. Returns false, leaving
+// the values read so far, if the text is not such a list.
+bool parse_parameters_json(const std::string& json, std::vector<double>& parameters) {
+    parameters.clear();
+    if (json.size() < 2 || json.front() != '[' || json.back() != ']') return false;
+
+    std::istringstream iss(json.substr(1, json.length() - 2));  // Remove [ ]
+    std::string param;
+    while (std::getline(iss, param, ',')) {
+        if (!param.empty()) {
+            char* end;
+            double value = std::strtod(param.c_str(), &end);
+            if (end == param.c_str() || *end != '\0') return false;
+            parameters.push_back(value);
+        }
+    }
+    return true;
+}
+
+}
 
 // StrategyRegistry Implementation
 StrategyRegistry::StrategyRegistry(const std::string& db_path) : db_path_(db_path), db_(nullptr) {}
 
 StrategyRegistry::~StrategyRegistry() {
+    stop_writer();
+    finalize_statements();
     if (db_) {
         sqlite3_close(db_);
     }
 }
 
 bool StrategyRegistry::initialize() {
-    // Open database
-    if (sqlite3_open(db_path_.c_str(), &db_) != SQLITE_OK) {
+    // Open database. The writer thread shares the connection, so ask for
+    // SQLite's serialized mode; db_mutex_ still guards statements and transactions.
+    if (sqlite3_open_v2(db_path_.c_str(), &db_,
+                        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_FULLMUTEX,
+                        nullptr) != SQLITE_OK) {
         std::cout << "Error opening database: " << sqlite3_errmsg(db_) << std::endl;
         return false;
     }
 
+    // WAL keeps readers off the writer's back; NORMAL sync only fsyncs at checkpoints
+    execute_sql("PRAGMA journal_mode=WAL;");
+    execute_sql("PRAGMA synchronous=NORMAL;");
+
     // Create tables
     const char* create_strategies_table =
         "CREATE TABLE IF NOT EXISTS strategies ("
@@ -69,58 +104,163 @@ bool StrategyRegistry::initialize() {
     execute_sql("CREATE INDEX IF NOT EXISTS idx_strategies_score ON strategies(composite_score DESC);");
     execute_sql("CREATE INDEX IF NOT EXISTS idx_strategies_tested ON strategies(tested_at DESC);");
 
+    if (!prepare_statements() || !load_tested_keys()) return false;
+
+    std::lock_guard<std::mutex> lock(db_mutex_);
+    refresh_underexplored_regions();
     return true;
 }
 
-bool StrategyRegistry::is_strategy_tested(const std::string& strategy_signature) {
-    if (!db_) return false;
-
+bool StrategyRegistry::load_tested_keys() {
     sqlite3_stmt* stmt;
-    const char* query = "SELECT COUNT(*) FROM strategies WHERE parameters_hash = ?;";
+    const char* query = "SELECT strategy_name, parameters_json FROM strategies;";
 
     if (sqlite3_prepare_v2(db_, query, -1, &stmt, nullptr) != SQLITE_OK) {
         return false;
     }
 
-    sqlite3_bind_text(stmt, 1, strategy_signature.c_str(), -1, SQLITE_STATIC);
-
-    bool exists = false;
-    if (sqlite3_step(stmt) == SQLITE_ROW) {
-        exists = (sqlite3_column_int(stmt, 0) > 0);
+    std::lock_guard<std::mutex> lock(keys_mutex_);
+    std::vector<double> parameters;
+    int bad_rows = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const char* name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+        const char* json = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        if (!name || !json || !parse_parameters_json(json, parameters)) {
+            ++bad_rows;  // Not a config we could have written; nothing to deduplicate against
+            continue;
+        }
+        tested_keys_.insert(parameter_key(name, parameters));
     }
 
     sqlite3_finalize(stmt);
-    return exists;
+    if (bad_rows) {
+        std::cout << "Warning: Skipped " << bad_rows << " strategy rows with unreadable parameters" << std::endl;
+    }
+    return true;
 }
 
-bool StrategyRegistry::save_strategy_result(const StrategyMetrics& metrics) {
-    if (!db_) return false;
+void StrategyRegistry::remember_config(const StrategyMetrics& metrics) {
+    uint64_t key = parameter_key(metrics.strategy_name, metrics.parameters);
+    std::lock_guard<std::mutex> lock(keys_mutex_);
+    tested_keys_.insert(key);
+}
 
-    // Convert parameters to JSON
-    std::ostringstream json_stream;
-    json_stream << "[";
-    for (size_t i = 0; i < metrics.parameters.size(); ++i) {
-        json_stream << metrics.parameters[i];
-        if (i < metrics.parameters.size() - 1) json_stream << ",";
+bool StrategyRegistry::is_config_tested(const std::string& strategy_name, const std::vector<double>& parameters) {
+    uint64_t key = parameter_key(strategy_name, parameters);
+    std::lock_guard<std::mutex> lock(keys_mutex_);
+    return tested_keys_.count(key) > 0;
+}
+
+uint64_t StrategyRegistry::parameter_key(const std::string& strategy_name, const std::vector<double>& parameters) {
+    // FNV-1a over the name and the bit patterns of the canonical values
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](uint64_t word) {
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (word >> (8 * i)) & 0xff;
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    for (char c : strategy_name) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
     }
-    json_stream << "]";
+    mix(0);  // Separates the name from the first value
 
-    std::string signature = generate_strategy_signature(metrics.parameters);
+    for (double value : StrategyFactory::canonical_parameters(strategy_name, parameters)) {
+        if (value == 0.0) value = 0.0;  // -0.0 and 0.0 build the same strategy
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        mix(bits);
+    }
 
-    sqlite3_stmt* stmt;
+    return hash;
+}
+
+bool StrategyRegistry::prepare_statements() {
     const char* insert_query =
         "INSERT OR REPLACE INTO strategies "
         "(strategy_name, parameters_hash, parameters_json, total_return, sharpe_ratio, "
         "max_drawdown, win_rate, profit_factor, total_trades, composite_score) "
         "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?);";
 
-    if (sqlite3_prepare_v2(db_, insert_query, -1, &stmt, nullptr) != SQLITE_OK) {
+    const char* upsert_region_query =
+        "INSERT INTO parameter_regions (region_id, exploration_count, best_score) VALUES (?, 1, ?) "
+        "ON CONFLICT(region_id) DO UPDATE SET exploration_count = exploration_count + 1, "
+        "best_score = MAX(best_score, excluded.best_score), last_tested = CURRENT_TIMESTAMP;";
+
+    const char* is_tested_query = "SELECT COUNT(*) FROM strategies WHERE parameters_hash = ?;";
+
+    if (sqlite3_prepare_v2(db_, insert_query, -1, &insert_strategy_stmt_, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db_, upsert_region_query, -1, &upsert_region_stmt_, nullptr) != SQLITE_OK ||
+        sqlite3_prepare_v2(db_, is_tested_query, -1, &is_tested_stmt_, nullptr) != SQLITE_OK) {
+        std::cout << "SQL Error: " << sqlite3_errmsg(db_) << std::endl;
+        finalize_statements();
         return false;
     }
 
+    return true;
+}
+
+void StrategyRegistry::finalize_statements() {
+    // sqlite3_finalize(nullptr) is a no-op
+    sqlite3_finalize(insert_strategy_stmt_);
+    sqlite3_finalize(upsert_region_stmt_);
+    sqlite3_finalize(is_tested_stmt_);
+    insert_strategy_stmt_ = nullptr;
+    upsert_region_stmt_ = nullptr;
+    is_tested_stmt_ = nullptr;
+}
+
+bool StrategyRegistry::is_strategy_tested(const std::string& strategy_signature) {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (pending_signatures_.count(strategy_signature)) return true;
+    }
+
+    std::lock_guard<std::mutex> lock(db_mutex_);
+    if (!db_ || !is_tested_stmt_) return false;
+
+    sqlite3_bind_text(is_tested_stmt_, 1, strategy_signature.c_str(), -1, SQLITE_STATIC);
+
+    bool exists = false;
+    if (sqlite3_step(is_tested_stmt_) == SQLITE_ROW) {
+        exists = (sqlite3_column_int(is_tested_stmt_, 0) > 0);
+    }
+
+    sqlite3_reset(is_tested_stmt_);
+    sqlite3_clear_bindings(is_tested_stmt_);
+    return exists;
+}
+
+bool StrategyRegistry::save_strategy_result(const StrategyMetrics& metrics) {
+    std::lock_guard<std::mutex> lock(db_mutex_);
+    if (!db_ || !insert_strategy_stmt_) return false;
+
+    remember_config(metrics);
+    bool success = write_batch({metrics});
+    refresh_underexplored_regions();
+    return success;
+}
+
+// Insert one result and bump its exploration region (caller holds db_mutex_)
+bool StrategyRegistry::write_strategy_row(const StrategyMetrics& metrics) {
+    // Convert parameters to JSON, with enough digits to round-trip exactly
+    std::ostringstream json_stream;
+    json_stream << std::setprecision(17) << "[";
+    for (size_t i = 0; i < metrics.parameters.size(); ++i) {
+        json_stream << metrics.parameters[i];
+        if (i < metrics.parameters.size() - 1) json_stream << ",";
+    }
+    json_stream << "]";
+
+    std::string parameters_json = json_stream.str();
+    std::string signature = generate_strategy_signature(metrics.parameters);
+
+    sqlite3_stmt* stmt = insert_strategy_stmt_;
     sqlite3_bind_text(stmt, 1, metrics.strategy_name.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_text(stmt, 2, signature.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, json_stream.str().c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 3, parameters_json.c_str(), -1, SQLITE_STATIC);
     sqlite3_bind_double(stmt, 4, metrics.total_return);
     sqlite3_bind_double(stmt, 5, metrics.sharpe_ratio);
     sqlite3_bind_double(stmt, 6, metrics.max_drawdown);
@@ -130,19 +270,141 @@ bool StrategyRegistry::save_strategy_result(const StrategyMetrics& metrics) {
     sqlite3_bind_double(stmt, 10, metrics.composite_score);
 
     bool success = (sqlite3_step(stmt) == SQLITE_DONE);
-    sqlite3_finalize(stmt);
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
 
     if (success) {
         // Update exploration region
         std::string region_id = generate_parameter_region_id(metrics.parameters);
-        update_exploration_region(region_id, metrics.composite_score);
+        success = upsert_region(region_id, metrics.composite_score);
     }
 
     return success;
 }
 
+// Caller holds db_mutex_
+bool StrategyRegistry::upsert_region(const std::string& region_id, double score) {
+    sqlite3_stmt* stmt = upsert_region_stmt_;
+    sqlite3_bind_text(stmt, 1, region_id.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_double(stmt, 2, score);
+
+    bool success = (sqlite3_step(stmt) == SQLITE_DONE);
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return success;
+}
+
+// Write a batch of results in a single transaction (caller holds db_mutex_)
+bool StrategyRegistry::write_batch(const std::vector<StrategyMetrics>& batch) {
+    if (!execute_sql("BEGIN;")) return false;
+
+    for (const auto& metrics : batch) {
+        if (!write_strategy_row(metrics)) {
+            std::cout << "SQL Error: " << sqlite3_errmsg(db_) << std::endl;
+            execute_sql("ROLLBACK;");
+            return false;
+        }
+    }
+
+    return execute_sql("COMMIT;");
+}
+
+bool StrategyRegistry::enqueue_strategy_result(const StrategyMetrics& metrics) {
+    if (!db_ || !insert_strategy_stmt_) return false;
+
+    remember_config(metrics);
+
+    std::string signature = generate_strategy_signature(metrics.parameters);
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!writer_thread_.joinable()) {
+            stop_writer_ = false;
+            writer_thread_ = std::thread(&StrategyRegistry::writer_loop, this);
+        }
+        write_queue_.push_back(metrics);
+        ++pending_signatures_[signature];
+        if (write_queue_.size() < batch_size_) return true;
+    }
+    queue_cv_.notify_one();
+    return true;
+}
+
+bool StrategyRegistry::flush() {
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+    if (writer_thread_.joinable()) {
+        flush_requested_ = true;
+        queue_cv_.notify_one();
+        drained_cv_.wait(lock, [this] { return write_queue_.empty() && in_flight_ == 0; });
+        flush_requested_ = false;
+    }
+
+    bool success = !write_failed_;
+    write_failed_ = false;
+    return success;
+}
+
+void StrategyRegistry::set_batch_size(size_t batch_size) {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    batch_size_ = std::max<size_t>(1, batch_size);
+}
+
+void StrategyRegistry::writer_loop() {
+    std::vector<StrategyMetrics> batch;
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+
+    for (;;) {
+        // Commit a partial batch when asked to, or after a quiet spell
+        queue_cv_.wait_for(lock, std::chrono::milliseconds(200), [this] {
+            return stop_writer_ || write_queue_.size() >= batch_size_ ||
+                   (flush_requested_ && !write_queue_.empty());
+        });
+
+        if (write_queue_.empty()) {
+            drained_cv_.notify_all();
+            if (stop_writer_) break;
+            continue;
+        }
+
+        size_t count = std::min(batch_size_, write_queue_.size());
+        batch.assign(std::make_move_iterator(write_queue_.begin()),
+                     std::make_move_iterator(write_queue_.begin() + count));
+        write_queue_.erase(write_queue_.begin(), write_queue_.begin() + count);
+        in_flight_ = count;
+        lock.unlock();
+
+        bool success;
+        {
+            std::lock_guard<std::mutex> db_lock(db_mutex_);
+            success = write_batch(batch);
+            refresh_underexplored_regions();
+        }
+
+        lock.lock();
+        // Committed rows are visible to is_strategy_tested from here on; a
+        // signature stays pending while another copy is still queued
+        for (const auto& metrics : batch) {
+            auto it = pending_signatures_.find(generate_strategy_signature(metrics.parameters));
+            if (it != pending_signatures_.end() && --it->second == 0) pending_signatures_.erase(it);
+        }
+        if (!success) write_failed_ = true;
+        in_flight_ = 0;
+        if (write_queue_.empty()) drained_cv_.notify_all();
+    }
+}
+
+void StrategyRegistry::stop_writer() {
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        if (!writer_thread_.joinable()) return;
+        stop_writer_ = true;
+    }
+    queue_cv_.notify_one();
+    writer_thread_.join();
+}
+
 std::vector<StrategyMetrics> StrategyRegistry::get_top_strategies(int limit) {
     std::vector<StrategyMetrics> strategies;
+    std::lock_guard<std::mutex> lock(db_mutex_);
     if (!db_) return strategies;
 
     sqlite3_stmt* stmt;
@@ -162,6 +424,7 @@ std::vector<StrategyMetrics> StrategyRegistry::get_top_strategies(int limit) {
 
 std::vector<StrategyMetrics> StrategyRegistry::get_recent_strategies(int limit) {
     std::vector<StrategyMetrics> strategies;
+    std::lock_guard<std::mutex> lock(db_mutex_);
     if (!db_) return strategies;
 
     sqlite3_stmt* stmt;
@@ -180,52 +443,29 @@ std::vector<StrategyMetrics> StrategyRegistry::get_recent_strategies(int limit)
 }
 
 bool StrategyRegistry::update_exploration_region(const std::string& region_id, double score) {
-    if (!db_) return false;
-
-    sqlite3_stmt* stmt;
-
-    // Try to update existing region
-    const char* update_query = "UPDATE parameter_regions SET exploration_count = exploration_count + 1, "
-                              "best_score = MAX(best_score, ?), last_tested = CURRENT_TIMESTAMP "
-                              "WHERE region_id = ?;";
-
-    if (sqlite3_prepare_v2(db_, update_query, -1, &stmt, nullptr) != SQLITE_OK) {
-        return false;
-    }
-
-    sqlite3_bind_double(stmt, 1, score);
-    sqlite3_bind_text(stmt, 2, region_id.c_str(), -1, SQLITE_STATIC);
-
-    bool updated = (sqlite3_step(stmt) == SQLITE_DONE);
-    sqlite3_finalize(stmt);
-
-    if (!updated) {
-        // Insert new region
-        const char* insert_query = "INSERT INTO parameter_regions (region_id, exploration_count, best_score) VALUES (?, 1, ?);";
-
-        if (sqlite3_prepare_v2(db_, insert_query, -1, &stmt, nullptr) != SQLITE_OK) {
-            return false;
-        }
-
-        sqlite3_bind_text(stmt, 1, region_id.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_double(stmt, 2, score);
+    std::lock_guard<std::mutex> lock(db_mutex_);
+    if (!db_ || !upsert_region_stmt_) return false;
 
-        updated = (sqlite3_step(stmt) == SQLITE_DONE);
-        sqlite3_finalize(stmt);
-    }
-
-    return updated;
+    bool success = upsert_region(region_id, score);
+    refresh_underexplored_regions();
+    return success;
 }
 
 std::vector<std::string> StrategyRegistry::get_underexplored_regions() {
+    std::lock_guard<std::mutex> lock(regions_mutex_);
+    return underexplored_regions_;
+}
+
+// Reload the underexplored region list (caller holds db_mutex_)
+void StrategyRegistry::refresh_underexplored_regions() {
     std::vector<std::string> regions;
-    if (!db_) return regions;
+    if (!db_) return;
 
     sqlite3_stmt* stmt;
     const char* query = "SELECT region_id FROM parameter_regions WHERE exploration_count < 5 ORDER BY exploration_count ASC;";
 
     if (sqlite3_prepare_v2(db_, query, -1, &stmt, nullptr) != SQLITE_OK) {
-        return regions;
+        return;
     }
 
     while (sqlite3_step(stmt) == SQLITE_ROW) {
@@ -233,10 +473,13 @@ std::vector<std::string> StrategyRegistry::get_underexplored_regions() {
     }
 
     sqlite3_finalize(stmt);
-    return regions;
+
+    std::lock_guard<std::mutex> lock(regions_mutex_);
+    underexplored_regions_.swap(regions);
 }
 
 int StrategyRegistry::get_exploration_count(const std::string& region_id) {
+    std::lock_guard<std::mutex> lock(db_mutex_);
     if (!db_) return 0;
 
     sqlite3_stmt* stmt;
@@ -258,6 +501,7 @@ int StrategyRegistry::get_exploration_count(const std::string& region_id) {
 }
 
 bool StrategyRegistry::cleanup_old_strategies(int keep_count) {
+    std::lock_guard<std::mutex> lock(db_mutex_);
     if (!db_) return false;
 
     // Delete old strategies, keeping only the top performers and most recent
@@ -280,10 +524,12 @@ bool StrategyRegistry::cleanup_old_strategies(int keep_count) {
 }
 
 bool StrategyRegistry::vacuum_database() {
+    std::lock_guard<std::mutex> lock(db_mutex_);
     return execute_sql("VACUUM;");
 }
 
 int StrategyRegistry::get_total_strategy_count() {
+    std::lock_guard<std::mutex> lock(db_mutex_);
     if (!db_) return 0;
 
     sqlite3_stmt* stmt;
@@ -303,6 +549,7 @@ int StrategyRegistry::get_total_strategy_count() {
 }
 
 double StrategyRegistry::get_average_score() {
+    std::lock_guard<std::mutex> lock(db_mutex_);
     if (!db_) return 0.0;
 
     sqlite3_stmt* stmt;
@@ -323,6 +570,7 @@ double StrategyRegistry::get_average_score() {
 
 std::vector<std::string> StrategyRegistry::get_most_successful_parameter_regions() {
     std::vector<std::string> regions;
+    std::lock_guard<std::mutex> lock(db_mutex_);
     if (!db_) return regions;
 
     sqlite3_stmt* stmt;
@@ -387,13 +635,9 @@ StrategyMetrics StrategyRegistry::load_strategy_from_db(sqlite3_stmt* stmt) {
     metrics.strategy_name = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
 
     // Parse parameters JSON
-    std::string params_json = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
-    std::istringstream iss(params_json.substr(1, params_json.length() - 2));  // Remove [ ]
-    std::string param;
-    while (std::getline(iss, param, ',')) {
-        if (!param.empty()) {
-            metrics.parameters.push_back(std::stod(param));
-        }
+    const char* json = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3));
+    if (!json || !parse_parameters_json(json, metrics.parameters)) {
+        std::cout << "Warning: Unreadable parameters for stored " << metrics.strategy_name << " strategy" << std::endl;
     }
 
     metrics.total_return = sqlite3_column_double(stmt, 4);
@@ -535,7 +779,7 @@ SmartStrategyTester::SmartStrategyTester(const std::string& db_path) {
 
 std::vector<StrategyMetrics> SmartStrategyTester::test_strategies_with_deduplication(
     const std::vector<StrategyTestConfig>& configs,
-    const std::vector<Bar>& data,
+    const BarSeries& data,
     int max_attempts) {
 
     std::vector<StrategyMetrics> results;
@@ -552,9 +796,7 @@ std::vector<StrategyMetrics> SmartStrategyTester::test_strategies_with_deduplica
             break;
         }
 
-        std::string signature = registry_->generate_strategy_signature(config.parameters);
-
-        if (registry_->is_strategy_tested(signature)) {
+        if (registry_->is_config_tested(config.strategy_name, config.parameters)) {
             std::cout << "Skipping duplicate strategy: " << config.strategy_name
                       << " (" << attempts + 1 << "/" << max_attempts << ")" << std::endl;
             attempts++;
@@ -567,18 +809,22 @@ std::vector<StrategyMetrics> SmartStrategyTester::test_strategies_with_deduplica
         StrategyMetrics metrics = test_strategy(config, data);
         results.push_back(metrics);
 
-        // Save result to registry
-        registry_->save_strategy_result(metrics);
+        // Queue result for the registry's background writer
+        registry_->enqueue_strategy_result(metrics);
 
         attempts++;
     }
 
+    if (!registry_->flush()) {
+        std::cout << "Warning: Some results could not be written to the strategy registry" << std::endl;
+    }
+
     std::cout << "Successfully tested " << results.size() << " unique strategies" << std::endl;
     return results;
 }
 
 std::vector<StrategyMetrics> SmartStrategyTester::discover_strategies(
-    const std::vector<Bar>& data,
+    const BarSeries& data,
     int target_count,
     int max_total_attempts) {
 
@@ -613,9 +859,7 @@ std::vector<StrategyMetrics> SmartStrategyTester::discover_strategies(
             config.parameters[1] = long_win;
         }
 
-        std::string signature = registry_->generate_strategy_signature(config.parameters);
-
-        if (registry_->is_strategy_tested(signature)) {
+        if (registry_->is_config_tested(config.strategy_name, config.parameters)) {
             attempts++;
             continue;
         }
@@ -626,13 +870,16 @@ std::vector<StrategyMetrics> SmartStrategyTester::discover_strategies(
         StrategyMetrics metrics = test_strategy(config, data);
         results.push_back(metrics);
 
-        // Save result and update exploration stats
-        registry_->save_strategy_result(metrics);
-        exploration_manager_->update_exploration_stats(config.parameters, metrics.composite_score);
+        // Queue result; the writer bumps its exploration region in the same transaction
+        registry_->enqueue_strategy_result(metrics);
 
         attempts++;
     }
 
+    if (!registry_->flush()) {
+        std::cout << "Warning: Some results could not be written to the strategy registry" << std::endl;
+    }
+
     std::cout << "\nDiscovered " << results.size() << " unique strategies in " << attempts << " attempts" << std::endl;
     return results;
 }
@@ -655,8 +902,7 @@ void SmartStrategyTester::print_registry_stats() {
 }
 
 bool SmartStrategyTester::is_config_duplicate(const StrategyTestConfig& config) {
-    std::string signature = registry_->generate_strategy_signature(config.parameters);
-    return registry_->is_strategy_tested(signature);
+    return registry_->is_config_tested(config.strategy_name, config.parameters);
 }
 
 StrategyTestConfig SmartStrategyTester::generate_unique_config(const ParameterGenConfig& gen_config) {
@@ -667,7 +913,8 @@ StrategyTestConfig SmartStrategyTester::generate_unique_config(const ParameterGe
     const int max_attempts = 100;
 
     do {
-        config.parameters = StrategyTester::generate_random_parameters_static(gen_config.parameter_ranges);
+        config.parameters = StrategyTester::generate_random_parameters_static(
+            gen_config.parameter_ranges, gen_config.seed, static_cast<size_t>(attempts));
         attempts++;
 
         if (attempts >= max_attempts) {
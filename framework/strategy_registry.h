@@ -4,9 +4,30 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <unordered_set>
+#include <unordered_map>
+#include <cstdint>
 #include <sqlite3.h>
 
 // Strategy registry for tracking tested strategies and preventing duplicates
+//
+// Results can be written synchronously (save_strategy_result) or queued with
+// enqueue_strategy_result, which never touches the database: a background
+// writer thread drains the queue and commits it in batches of set_batch_size()
+// rows per transaction (256 by default). Queued results count as tested straight away.
+// Call flush() before reading results back.
+//
+// Each committed row also bumps its parameter region in the same transaction.
+// get_underexplored_regions() serves a list the writer refreshes after every
+// commit, so callers on simulation threads never wait for the database.
+//
+// Duplicate checks for whole configs go through an in-memory set of
+// parameter_key() hashes, preloaded from the database by initialize(), so
+// is_config_tested() never queries SQLite.
 class StrategyRegistry {
 public:
     StrategyRegistry(const std::string& db_path = "strategy_registry.db");
@@ -17,10 +38,16 @@ public:
 
     // Strategy management
     bool is_strategy_tested(const std::string& strategy_signature);
+    bool is_config_tested(const std::string& strategy_name, const std::vector<double>& parameters);
     bool save_strategy_result(const StrategyMetrics& metrics);
     std::vector<StrategyMetrics> get_top_strategies(int limit = 100);
     std::vector<StrategyMetrics> get_recent_strategies(int limit = 10000);
 
+    // Batched background writes
+    bool enqueue_strategy_result(const StrategyMetrics& metrics);
+    bool flush();  // Wait until every queued result is committed; false if any batch failed
+    void set_batch_size(size_t batch_size);
+
     // Exploration tracking
     bool update_exploration_region(const std::string& region_id, double score);
     std::vector<std::string> get_underexplored_regions();
@@ -39,9 +66,52 @@ private:
     sqlite3* db_;
     std::string db_path_;
 
+    // Cached statements, prepared once in initialize()
+    sqlite3_stmt* insert_strategy_stmt_ = nullptr;
+    sqlite3_stmt* upsert_region_stmt_ = nullptr;
+    sqlite3_stmt* is_tested_stmt_ = nullptr;
+
+    // Keys of every stored or queued config (see parameter_key)
+    std::mutex keys_mutex_;
+    std::unordered_set<uint64_t> tested_keys_;
+
+    // Guards the connection and the cached statements
+    std::mutex db_mutex_;
+
+    // Regions explored fewer than 5 times, as of the last commit
+    std::mutex regions_mutex_;
+    std::vector<std::string> underexplored_regions_;
+
+    // Write queue shared with the writer thread
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cv_;     // Signals the writer
+    std::condition_variable drained_cv_;   // Signals flush()
+    std::deque<StrategyMetrics> write_queue_;
+    std::unordered_map<std::string, int> pending_signatures_;  // Queued or in flight rows per signature
+    size_t batch_size_ = 256;
+    size_t in_flight_ = 0;
+    bool flush_requested_ = false;
+    bool stop_writer_ = false;
+    bool write_failed_ = false;
+    std::thread writer_thread_;
+
     // Helper methods
     bool execute_sql(const std::string& sql);
+    bool prepare_statements();
+    bool load_tested_keys();
+    void remember_config(const StrategyMetrics& metrics);
+    void finalize_statements();
+    bool write_strategy_row(const StrategyMetrics& metrics);
+    bool upsert_region(const std::string& region_id, double score);
+    bool write_batch(const std::vector<StrategyMetrics>& batch);
+    void refresh_underexplored_regions();
+    void writer_loop();
+    void stop_writer();
 public:
+    // 64-bit hash of the strategy name and its canonical parameters
+    // (StrategyFactory::canonical_parameters). Configs that the factory turns
+    // into the same strategy, e.g. short windows 10.3 and 10.7, share a key.
+    static uint64_t parameter_key(const std::string& strategy_name, const std::vector<double>& parameters);
     std::string generate_strategy_signature(const std::vector<double>& parameters);
     std::string generate_parameter_region_id(const std::vector<double>& parameters);
     StrategyMetrics load_strategy_from_db(sqlite3_stmt* stmt);
@@ -85,12 +155,12 @@ public:
     // Enhanced testing with deduplication
     std::vector<StrategyMetrics> test_strategies_with_deduplication(
         const std::vector<StrategyTestConfig>& configs,
-        const std::vector<Bar>& data,
+        const BarSeries& data,
         int max_attempts = 1000);
 
     // Generate and test strategies intelligently
     std::vector<StrategyMetrics> discover_strategies(
-        const std::vector<Bar>& data,
+        const BarSeries& data,
         int target_count = 100,
         int max_total_attempts = 1000);
 
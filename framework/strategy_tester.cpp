@@ -1,6 +1,8 @@
 #include "strategy_tester.h"
 #include "strategy.h"
 #include "strategy_factory.h"
+#include "thread_pool.h"
+#include "log.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -9,6 +11,7 @@
 #include <random>
 #include <cmath>
 #include <iomanip>
+#include <mutex>
 
 // Calculate composite score for strategy ranking
 void StrategyMetrics::calculate_composite_score() {
@@ -29,33 +32,39 @@ void StrategyMetrics::calculate_composite_score() {
 
 // Test a single strategy configuration
 StrategyMetrics StrategyTester::test_strategy(const StrategyTestConfig& config, const std::vector<Bar>& data) {
+  return test_strategy(config, BarSeries(data));
+}
+
+StrategyMetrics StrategyTester::test_strategy(const StrategyTestConfig& config, const BarSeries& data) {
+  return run_test(config, data, &data);
+}
+
+StrategyMetrics StrategyTester::test_strategy_unchecked(const StrategyTestConfig& config, BarSpan data) {
+  return run_test(config, data, nullptr);
+}
+
+StrategyMetrics StrategyTester::run_test(const StrategyTestConfig& config, BarSpan data, const BarSeries* series) {
   StrategyMetrics metrics;
   metrics.strategy_name = config.strategy_name;
   metrics.parameters = config.parameters;
   metrics.symbol = config.symbol;
 
   try {
-    // Phase 1: Data Integrity Validation
-    std::cout << "\n" << std::string(60, '=') << std::endl;
-    std::cout << "PHASE 1: DATA INTEGRITY VALIDATION" << std::endl;
-    std::cout << std::string(60, '=') << std::endl;
-
-    // Validate data integrity to prevent lookahead bias
-    validate_chronological_order(data);
-    validate_data_integrity(data);
-    validate_ohlc_relationships(data);
-
-    std::cout << "\n✅ Data validation complete - proceeding with strategy testing\n" << std::endl;
+    // Phase 1: Data Integrity Validation (once per BarSeries)
+    if (series) validate_dataset(*series);
 
     // Create strategy based on name and parameters
     std::unique_ptr<Strategy> strategy = StrategyFactory::create_strategy(
         config.strategy_name, config.parameters, config.symbol);
 
     if (!strategy) {
-      std::cout << "Failed to create strategy: " << config.strategy_name << std::endl;
+      Log::Line(Log::Level::Warn) << "Failed to create strategy: " << config.strategy_name << std::endl;
       return metrics;
     }
 
+    // Unchecked runs are MCPT replications, hundreds per configuration
+    if (!series) strategy->set_report(false);
+
     // Configure risk management
     // Note: This would need to be implemented in the strategy classes
 
@@ -63,7 +72,7 @@ StrategyMetrics StrategyTester::test_strategy(const StrategyTestConfig& config,
     std::vector<double> portfolio_values = run_strategy_simulation(strategy, data);
 
     if (portfolio_values.empty()) {
-      std::cout << "No portfolio values generated for strategy" << std::endl;
+      Log::Line(Log::Level::Warn) << "No portfolio values generated for strategy" << std::endl;
       return metrics;
     }
 
@@ -132,39 +141,60 @@ StrategyMetrics StrategyTester::test_strategy(const StrategyTestConfig& config,
 
     // Store the original market data for statistical validation
     // This is crucial for lookahead bias detection algorithms
-    metrics.market_data = data;
+    // (shares the caller's buffer; no per-config copy)
+    if (series) metrics.market_data = *series;
 
   } catch (const std::exception& e) {
-    std::cout << "Error testing strategy " << config.strategy_name << ": " << e.what() << std::endl;
+    Log::Line(Log::Level::Error) << "Error testing strategy " << config.strategy_name << ": " << e.what() << std::endl;
   }
 
   return metrics;
 }
 
+// Keying the stream on the config index (not the worker) keeps generation
+// reproducible for any thread count
+std::mt19937_64 make_config_rng(unsigned long long seed, size_t index) {
+  std::seed_seq seq{
+    static_cast<unsigned>(seed & 0xFFFFFFFFULL),
+    static_cast<unsigned>(seed >> 32),
+    static_cast<unsigned>(index & 0xFFFFFFFFULL),
+    static_cast<unsigned>(static_cast<unsigned long long>(index) >> 32)
+  };
+  return std::mt19937_64(seq);
+}
+
 // Generate multiple strategy configurations
 std::vector<StrategyTestConfig> StrategyTester::generate_strategy_configs(const ParameterGenConfig& gen_config) {
   std::vector<StrategyTestConfig> configs;
 
-  auto random_between = [](double min_val, double max_val) {
-    return min_val + (max_val - min_val) * (static_cast<double>(rand()) / RAND_MAX);
-  };
-
   std::string type = gen_config.strategy_type;
   std::transform(type.begin(), type.end(), type.begin(), [](unsigned char c) {
     return static_cast<char>(std::toupper(c));
   });
 
+  if (type != "SMA" && type != "RSI" && type != "MACD") {
+    return configs;
+  }
+
   const auto& ranges = gen_config.parameter_ranges;
+  const unsigned long long base_seed = gen_config.seed;
 
-  if (type == "SMA") {
-    std::pair<double, double> short_range = ranges.size() > 0 ? ranges[0] : std::make_pair(5.0, 50.0);
-    std::pair<double, double> long_range = ranges.size() > 1 ? ranges[1] : std::make_pair(20.0, 200.0);
-    std::pair<double, double> fee_range = ranges.size() > 2 ? ranges[2] : std::make_pair(0.0001, 0.0010);
+  auto make_config = [&](size_t index) {
+    std::mt19937_64 rng = make_config_rng(base_seed, index);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
 
-    for (int i = 0; i < gen_config.num_samples; ++i) {
-      StrategyTestConfig config;
-      config.strategy_name = "SMA";
-      config.symbol = "DEMO";
+    auto random_between = [&](double min_val, double max_val) {
+      return min_val + (max_val - min_val) * unit(rng);
+    };
+
+    StrategyTestConfig config;
+    config.strategy_name = type;
+    config.symbol = "DEMO";
+
+    if (type == "SMA") {
+      std::pair<double, double> short_range = ranges.size() > 0 ? ranges[0] : std::make_pair(5.0, 50.0);
+      std::pair<double, double> long_range = ranges.size() > 1 ? ranges[1] : std::make_pair(20.0, 200.0);
+      std::pair<double, double> fee_range = ranges.size() > 2 ? ranges[2] : std::make_pair(0.0001, 0.0010);
 
       int short_win = static_cast<int>(random_between(short_range.first, short_range.second));
       int long_win = static_cast<int>(random_between(long_range.first, long_range.second));
@@ -174,21 +204,14 @@ std::vector<StrategyTestConfig> StrategyTester::generate_strategy_configs(const
       double fee = random_between(fee_range.first, fee_range.second);
 
       config.parameters = {static_cast<double>(short_win), static_cast<double>(long_win), fee};
-      configs.push_back(config);
-    }
-  } else if (type == "RSI") {
-    std::vector<std::pair<double, double>> defaults = {
-      {5.0, 30.0},    // period
-      {65.0, 90.0},   // overbought
-      {10.0, 40.0},   // oversold
-      {1.0, 5.0},     // confirmation periods
-      {0.0001, 0.001} // fee
-    };
-
-    for (int i = 0; i < gen_config.num_samples; ++i) {
-      StrategyTestConfig config;
-      config.strategy_name = "RSI";
-      config.symbol = "DEMO";
+    } else if (type == "RSI") {
+      std::vector<std::pair<double, double>> defaults = {
+        {5.0, 30.0},    // period
+        {65.0, 90.0},   // overbought
+        {10.0, 40.0},   // oversold
+        {1.0, 5.0},     // confirmation periods
+        {0.0001, 0.001} // fee
+      };
 
       std::vector<double> params;
       for (size_t idx = 0; idx < defaults.size(); ++idx) {
@@ -212,22 +235,15 @@ std::vector<StrategyTestConfig> StrategyTester::generate_strategy_configs(const
         static_cast<double>(confirmation),
         fee_val
       };
-      configs.push_back(config);
-    }
-  } else if (type == "MACD") {
-    std::vector<std::pair<double, double>> defaults = {
-      {8.0, 16.0},    // fast period
-      {20.0, 40.0},   // slow period
-      {5.0, 15.0},    // signal period
-      {0.5, 1.5},     // overbought threshold
-      {-1.5, -0.5},   // oversold threshold
-      {0.0001, 0.001} // fee
-    };
-
-    for (int i = 0; i < gen_config.num_samples; ++i) {
-      StrategyTestConfig config;
-      config.strategy_name = "MACD";
-      config.symbol = "DEMO";
+    } else {
+      std::vector<std::pair<double, double>> defaults = {
+        {8.0, 16.0},    // fast period
+        {20.0, 40.0},   // slow period
+        {5.0, 15.0},    // signal period
+        {0.5, 1.5},     // overbought threshold
+        {-1.5, -0.5},   // oversold threshold
+        {0.0001, 0.001} // fee
+      };
 
       std::vector<double> params;
       for (size_t idx = 0; idx < defaults.size(); ++idx) {
@@ -250,8 +266,23 @@ std::vector<StrategyTestConfig> StrategyTester::generate_strategy_configs(const
         oversold,
         fee_val
       };
-      configs.push_back(config);
     }
+
+    return config;
+  };
+
+  size_t num_samples = static_cast<size_t>(std::max(0, gen_config.num_samples));
+  configs.resize(num_samples);
+
+  if (num_threads_ == 1) {
+    for (size_t i = 0; i < num_samples; ++i) {
+      configs[i] = make_config(i);
+    }
+  } else {
+    WorkStealingPool pool(num_threads_);
+    pool.parallel_for(num_samples, [&](size_t i, unsigned) {
+      configs[i] = make_config(i);
+    });
   }
 
   return configs;
@@ -261,36 +292,95 @@ std::vector<StrategyTestConfig> StrategyTester::generate_strategy_configs(const
 std::vector<StrategyMetrics> StrategyTester::test_multiple_strategies(
     const std::vector<StrategyTestConfig>& configs,
     const std::vector<Bar>& data) {
+  return test_multiple_strategies(configs, BarSeries(data));
+}
 
-  std::vector<StrategyMetrics> results;
-  std::cout << "\n" << std::string(80, '=') << std::endl;
-  std::cout << "STRATEGY TESTING BATCH - " << configs.size() << " configurations" << std::endl;
-  std::cout << std::string(80, '=') << std::endl;
+std::vector<StrategyMetrics> StrategyTester::test_multiple_strategies(
+    const std::vector<StrategyTestConfig>& configs,
+    const BarSeries& data) {
 
-  for (size_t i = 0; i < configs.size(); ++i) {
-    const auto& config = configs[i];
+  std::vector<StrategyMetrics> results(configs.size());
+  unsigned num_workers = WorkStealingPool::resolve_thread_count(num_threads_);
 
-    std::cout << "Testing " << (i + 1) << "/" << configs.size() << ": "
-              << config.strategy_name;
+  {
+    Log::Line banner(Log::Level::Info);
+    banner << "\n" << std::string(80, '=') << std::endl;
+    banner << "STRATEGY TESTING BATCH - " << configs.size() << " configurations";
+    if (num_workers > 1) {
+      banner << " on " << num_workers << " threads";
+    }
+    banner << std::endl;
+    banner << std::string(80, '=') << std::endl;
+  }
+  Log::Event("batch_start")
+      .field("configs", configs.size())
+      .field("threads", static_cast<size_t>(num_workers));
+
+  auto describe_config = [&](size_t i) {
+    const auto& config = configs[i];
+    std::ostringstream line;
+    line << "Testing " << (i + 1) << "/" << configs.size() << ": "
+         << config.strategy_name;
 
     if (!config.parameters.empty()) {
-      std::cout << " (";
+      line << " (";
       for (size_t j = 0; j < config.parameters.size(); ++j) {
-        std::cout << config.parameters[j];
-        if (j < config.parameters.size() - 1) std::cout << ", ";
+        line << config.parameters[j];
+        if (j < config.parameters.size() - 1) line << ", ";
       }
-      std::cout << ")";
+      line << ")";
     }
-    std::cout << std::endl;
+    return line.str();
+  };
+
+  auto describe_result = [](const StrategyMetrics& metrics) {
+    std::ostringstream line;
+    line << "  Result: Return=" << (metrics.total_return * 100.0) << "%, "
+         << "Sharpe=" << metrics.sharpe_ratio << ", "
+         << "MaxDD=" << (metrics.max_drawdown * 100.0) << "%, "
+         << "Trades=" << metrics.total_trades;
+    return line.str();
+  };
 
-    StrategyMetrics metrics = test_strategy(config, data);
-    results.push_back(metrics);
+  auto record_result = [](size_t i, const StrategyMetrics& metrics) {
+    Log::Event("result")
+        .field("index", i)
+        .field("strategy", metrics.strategy_name)
+        .field("params", metrics.parameters)
+        .field("total_return", metrics.total_return)
+        .field("sharpe", metrics.sharpe_ratio)
+        .field("max_drawdown", metrics.max_drawdown)
+        .field("win_rate", metrics.win_rate)
+        .field("trades", metrics.total_trades)
+        .field("score", metrics.composite_score);
+  };
 
-    // Print immediate results
-    std::cout << "  Result: Return=" << (metrics.total_return * 100.0) << "%, "
-              << "Sharpe=" << metrics.sharpe_ratio << ", "
-              << "MaxDD=" << (metrics.max_drawdown * 100.0) << "%, "
-              << "Trades=" << metrics.total_trades << std::endl;
+  if (num_workers == 1) {
+    for (size_t i = 0; i < configs.size(); ++i) {
+      if (Log::enabled(Log::Level::Info)) {
+        Log::Line(Log::Level::Info) << describe_config(i) << std::endl;
+      }
+
+      results[i] = test_strategy(configs[i], data);
+
+      // Print immediate results
+      if (Log::enabled(Log::Level::Info)) {
+        Log::Line(Log::Level::Info) << describe_result(results[i]) << std::endl;
+      }
+      record_result(i, results[i]);
+    }
+  } else {
+    // Each slot is written by exactly one task, so results stay in config order
+    WorkStealingPool pool(static_cast<int>(num_workers));
+    pool.parallel_for(configs.size(), [&](size_t i, unsigned) {
+      results[i] = test_strategy(configs[i], data);
+
+      // One message per config, so concurrent workers never interleave lines
+      if (Log::enabled(Log::Level::Info)) {
+        Log::Line(Log::Level::Info) << describe_config(i) << "\n" << describe_result(results[i]) << std::endl;
+      }
+      record_result(i, results[i]);
+    });
   }
 
   // Sort by composite score (descending)
@@ -299,8 +389,8 @@ std::vector<StrategyMetrics> StrategyTester::test_multiple_strategies(
       return a.composite_score > b.composite_score;
     });
 
-  std::cout << std::string(80, '=') << std::endl;
-  std::cout << "BATCH TESTING COMPLETE" << std::endl;
+  Log::Line(Log::Level::Info) << std::string(80, '=') << std::endl;
+  Log::Line(Log::Level::Info) << "BATCH TESTING COMPLETE" << std::endl;
 
   return results;
 }
@@ -312,9 +402,12 @@ std::vector<StrategyMetrics> StrategyTester::select_top_strategies(
 
   int selection_count = std::min(num_top, static_cast<int>(results.size()));
 
-  std::cout << "\n" << std::string(80, '=') << std::endl;
-  std::cout << "SELECTING TOP " << selection_count << " STRATEGIES" << std::endl;
-  std::cout << std::string(80, '=') << std::endl;
+  {
+    Log::Line banner(Log::Level::Info);
+    banner << "\n" << std::string(80, '=') << std::endl;
+    banner << "SELECTING TOP " << selection_count << " STRATEGIES" << std::endl;
+    banner << std::string(80, '=') << std::endl;
+  }
 
   std::vector<StrategyMetrics> top_strategies(results.begin(), results.begin() + selection_count);
 
@@ -431,19 +524,19 @@ double StrategyTester::calculate_sortino_ratio(const std::vector<double>& return
   return (annualized_return - risk_free_rate) / (downside_std_dev * std::sqrt(252));
 }
 
-std::vector<double> StrategyTester::generate_random_parameters(const std::vector<std::pair<double, double>>& ranges) {
-  std::vector<double> params;
-  for (const auto& range : ranges) {
-    double param = range.first + (range.second - range.first) * (static_cast<double>(rand()) / RAND_MAX);
-    params.push_back(param);
-  }
-  return params;
+std::vector<double> StrategyTester::generate_random_parameters(const std::vector<std::pair<double, double>>& ranges,
+                                                               unsigned long long seed, size_t index) {
+  return generate_random_parameters_static(ranges, seed, index);
 }
 
-std::vector<double> StrategyTester::generate_random_parameters_static(const std::vector<std::pair<double, double>>& ranges) {
+std::vector<double> StrategyTester::generate_random_parameters_static(const std::vector<std::pair<double, double>>& ranges,
+                                                                      unsigned long long seed, size_t index) {
+  std::mt19937_64 rng = make_config_rng(seed, index);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+
   std::vector<double> params;
   for (const auto& range : ranges) {
-    double param = range.first + (range.second - range.first) * (static_cast<double>(rand()) / RAND_MAX);
+    double param = range.first + (range.second - range.first) * unit(rng);
     params.push_back(param);
   }
   return params;
@@ -451,9 +544,10 @@ std::vector<double> StrategyTester::generate_random_parameters_static(const std:
 
 std::vector<double> StrategyTester::run_strategy_simulation(
     std::unique_ptr<Strategy>& strategy,
-    const std::vector<Bar>& data) {
+    BarSpan data) {
 
   std::vector<double> portfolio_values;
+  portfolio_values.reserve(data.size() + 1);
 
   // Initialize strategy
   strategy->on_start();
@@ -479,38 +573,40 @@ std::vector<double> StrategyTester::run_strategy_simulation(
 }
 
 void StrategyTester::print_strategy_metrics(const StrategyMetrics& metrics) {
-  std::cout << "\n" << std::string(60, '-') << std::endl;
-  std::cout << "STRATEGY: " << metrics.strategy_name << std::endl;
-  std::cout << "PARAMETERS: ";
+  Log::Line out(Log::Level::Info);
+  out << "\n" << std::string(60, '-') << std::endl;
+  out << "STRATEGY: " << metrics.strategy_name << std::endl;
+  out << "PARAMETERS: ";
   for (size_t i = 0; i < metrics.parameters.size(); ++i) {
-    std::cout << metrics.parameters[i];
-    if (i < metrics.parameters.size() - 1) std::cout << ", ";
+    out << metrics.parameters[i];
+    if (i < metrics.parameters.size() - 1) out << ", ";
   }
-  std::cout << std::endl;
-
-  std::cout << "PERFORMANCE:" << std::endl;
-  std::cout << "  Total Return: " << std::fixed << std::setprecision(2) << (metrics.total_return * 100.0) << "%" << std::endl;
-  std::cout << "  Sharpe Ratio: " << std::setprecision(3) << metrics.sharpe_ratio << std::endl;
-  std::cout << "  Max Drawdown: " << std::setprecision(2) << (metrics.max_drawdown * 100.0) << "%" << std::endl;
-  std::cout << "  Win Rate: " << std::setprecision(1) << (metrics.win_rate * 100.0) << "%" << std::endl;
-  std::cout << "  Profit Factor: " << std::setprecision(2) << metrics.profit_factor << std::endl;
-  std::cout << "  Total Trades: " << metrics.total_trades << std::endl;
-
-  std::cout << "RISK METRICS:" << std::endl;
-  std::cout << "  Calmar Ratio: " << std::setprecision(3) << metrics.calmar_ratio << std::endl;
-  std::cout << "  Sortino Ratio: " << std::setprecision(3) << metrics.sortino_ratio << std::endl;
-  std::cout << "  VaR 95%: " << std::setprecision(2) << (metrics.var_95 * 100.0) << "%" << std::endl;
-
-  std::cout << "COMPOSITE SCORE: " << std::setprecision(4) << metrics.composite_score << std::endl;
-  std::cout << std::string(60, '-') << std::endl;
+  out << std::endl;
+
+  out << "PERFORMANCE:" << std::endl;
+  out << "  Total Return: " << std::fixed << std::setprecision(2) << (metrics.total_return * 100.0) << "%" << std::endl;
+  out << "  Sharpe Ratio: " << std::setprecision(3) << metrics.sharpe_ratio << std::endl;
+  out << "  Max Drawdown: " << std::setprecision(2) << (metrics.max_drawdown * 100.0) << "%" << std::endl;
+  out << "  Win Rate: " << std::setprecision(1) << (metrics.win_rate * 100.0) << "%" << std::endl;
+  out << "  Profit Factor: " << std::setprecision(2) << metrics.profit_factor << std::endl;
+  out << "  Total Trades: " << metrics.total_trades << std::endl;
+
+  out << "RISK METRICS:" << std::endl;
+  out << "  Calmar Ratio: " << std::setprecision(3) << metrics.calmar_ratio << std::endl;
+  out << "  Sortino Ratio: " << std::setprecision(3) << metrics.sortino_ratio << std::endl;
+  out << "  VaR 95%: " << std::setprecision(2) << (metrics.var_95 * 100.0) << "%" << std::endl;
+
+  out << "COMPOSITE SCORE: " << std::setprecision(4) << metrics.composite_score << std::endl;
+  out << std::string(60, '-') << std::endl;
 }
 
 void StrategyTester::print_strategy_comparison(const std::vector<StrategyMetrics>& metrics) {
-  std::cout << "\n" << std::string(100, '=') << std::endl;
-  std::cout << "TOP STRATEGIES COMPARISON" << std::endl;
-  std::cout << std::string(100, '=') << std::endl;
+  Log::Line out(Log::Level::Info);
+  out << "\n" << std::string(100, '=') << std::endl;
+  out << "TOP STRATEGIES COMPARISON" << std::endl;
+  out << std::string(100, '=') << std::endl;
 
-  std::cout << std::left << std::setw(15) << "Rank"
+  out << std::left << std::setw(15) << "Rank"
             << std::setw(12) << "Strategy"
             << std::setw(10) << "Return%"
             << std::setw(10) << "Sharpe"
@@ -518,11 +614,11 @@ void StrategyTester::print_strategy_comparison(const std::vector<StrategyMetrics
             << std::setw(8) << "Win%"
             << std::setw(10) << "Trades"
             << std::setw(12) << "Score" << std::endl;
-  std::cout << std::string(100, '-') << std::endl;
+  out << std::string(100, '-') << std::endl;
 
   for (size_t i = 0; i < metrics.size(); ++i) {
     const auto& m = metrics[i];
-    std::cout << std::left << std::setw(15) << (i + 1)
+    out << std::left << std::setw(15) << (i + 1)
               << std::setw(12) << m.strategy_name.substr(0, 11)
               << std::setw(10) << std::fixed << std::setprecision(1) << (m.total_return * 100.0)
               << std::setw(10) << std::setprecision(2) << m.sharpe_ratio
@@ -532,47 +628,87 @@ void StrategyTester::print_strategy_comparison(const std::vector<StrategyMetrics
               << std::setw(12) << std::setprecision(4) << m.composite_score << std::endl;
   }
 
-  std::cout << std::string(100, '=') << std::endl;
+  out << std::string(100, '=') << std::endl;
+}
+
+void StrategyTester::validate_dataset(const BarSeries& data) {
+  BarSeries::Validation& validation = data.validation();
+
+  // Workers sharing the series wait here for the one report
+  std::call_once(validation.once, [&] {
+    {
+      Log::Line banner(Log::Level::Info);
+      banner << "\n" << std::string(60, '=') << std::endl;
+      banner << "PHASE 1: DATA INTEGRITY VALIDATION" << std::endl;
+      banner << std::string(60, '=') << std::endl;
+    }
+
+    try {
+      // Validate data integrity to prevent lookahead bias
+      validate_chronological_order(data);
+      validate_data_integrity(data);
+      validate_ohlc_relationships(data);
+
+      Log::Line(Log::Level::Info) << "\n✅ Data validation complete - proceeding with strategy testing\n" << std::endl;
+    } catch (const std::runtime_error& e) {
+      validation.error = e.what();
+    }
+  });
+
+  if (!validation.error.empty()) {
+    throw std::runtime_error(validation.error);
+  }
 }
 
 // Data integrity validation methods
-void StrategyTester::validate_chronological_order(const std::vector<Bar>& data) {
+void StrategyTester::validate_chronological_order(BarSpan data) {
   if (data.size() < 2) {
-    std::cout << "✓ Chronological Validation: Dataset too small for validation" << std::endl;
+    Log::Line(Log::Level::Info) << "✓ Chronological Validation: Dataset too small for validation" << std::endl;
     return;
   }
 
-  std::cout << "🔍 Validating chronological order of " << data.size() << " bars..." << std::endl;
+  Log::Line(Log::Level::Info) << "🔍 Validating chronological order of " << data.size() << " bars..." << std::endl;
 
   int violations = 0;
   std::vector<size_t> violation_indices;
 
   for (size_t i = 1; i < data.size(); ++i) {
-    if (data[i].date <= data[i-1].date) {
+    // Intraday bars share a date, so order by timestamp (date for daily files).
+    // Equal timestamps fall back to the date: an impossible calendar date such
+    // as 20210229 normalises onto the following day.
+    int64_t t = bar_timestamp(data[i]);
+    int64_t prev_t = bar_timestamp(data[i-1]);
+    if (t < prev_t || (t == prev_t && data[i].date <= data[i-1].date)) {
       violations++;
       violation_indices.push_back(i);
     }
   }
 
   if (violations == 0) {
-    std::cout << "✅ Chronological Order: All " << data.size() << " bars are in correct chronological order" << std::endl;
+    Log::Line(Log::Level::Info) << "✅ Chronological Order: All " << data.size() << " bars are in correct chronological order" << std::endl;
   } else {
-    std::cout << "❌ Chronological Order: Found " << violations << " violations!" << std::endl;
-    for (size_t idx : violation_indices) {
-      std::cout << "   Violation at index " << idx << ": "
-                << "Date " << data[idx].date
-                << " <= Previous date " << data[idx-1].date << std::endl;
+    Log::Line(Log::Level::Warn) << "❌ Chronological Order: Found " << violations << " violations!" << std::endl;
+    const size_t shown = std::min<size_t>(violation_indices.size(), 10);
+    for (size_t k = 0; k < shown; ++k) {
+      size_t idx = violation_indices[k];
+      Log::Line(Log::Level::Warn) << "   Violation at index " << idx << ": "
+                << "Date " << data[idx].date << " (t=" << bar_timestamp(data[idx]) << ")"
+                << " <= Previous date " << data[idx-1].date << " (t=" << bar_timestamp(data[idx-1]) << ")"
+                << std::endl;
+    }
+    if (violation_indices.size() > shown) {
+      Log::Line(Log::Level::Warn) << "   ... and " << (violation_indices.size() - shown) << " more" << std::endl;
     }
     throw std::runtime_error("Data is NOT in chronological order! Lookahead bias possible.");
   }
 }
 
-void StrategyTester::validate_data_integrity(const std::vector<Bar>& data) {
+void StrategyTester::validate_data_integrity(BarSpan data) {
   if (data.empty()) {
     throw std::runtime_error("Data integrity validation failed: No data provided");
   }
 
-  std::cout << "🔍 Validating data integrity of " << data.size() << " bars..." << std::endl;
+  Log::Line(Log::Level::Info) << "🔍 Validating data integrity of " << data.size() << " bars..." << std::endl;
 
   int issues_found = 0;
 
@@ -580,7 +716,7 @@ void StrategyTester::validate_data_integrity(const std::vector<Bar>& data) {
   for (size_t i = 0; i < data.size(); ++i) {
     if (data[i].date == 0) {
       issues_found++;
-      std::cout << "   Warning: Missing date at index " << i << std::endl;
+      Log::Line(Log::Level::Warn) << "   Warning: Missing date at index " << i << std::endl;
     }
   }
 
@@ -590,7 +726,7 @@ void StrategyTester::validate_data_integrity(const std::vector<Bar>& data) {
 
     if (bar.open <= 0 || bar.high <= 0 || bar.low <= 0 || bar.close <= 0) {
       issues_found++;
-      std::cout << "   Error: Non-positive price values at index " << i
+      Log::Line(Log::Level::Warn) << "   Error: Non-positive price values at index " << i
                 << " (O:" << bar.open << " H:" << bar.high
                 << " L:" << bar.low << " C:" << bar.close << ")" << std::endl;
     }
@@ -600,7 +736,7 @@ void StrategyTester::validate_data_integrity(const std::vector<Bar>& data) {
     if (bar.open > max_reasonable_price || bar.high > max_reasonable_price ||
         bar.low > max_reasonable_price || bar.close > max_reasonable_price) {
       issues_found++;
-      std::cout << "   Warning: Extremely large price values at index " << i << std::endl;
+      Log::Line(Log::Level::Warn) << "   Warning: Extremely large price values at index " << i << std::endl;
     }
   }
 
@@ -619,26 +755,26 @@ void StrategyTester::validate_data_integrity(const std::vector<Bar>& data) {
     if (data[i].date - data[i-1].date > 5) {  // More than 5 days gap
       gap_count++;
       if (gap_count <= 3) {  // Only show first few gaps
-        std::cout << "   Warning: Large date gap at index " << i
+        Log::Line(Log::Level::Warn) << "   Warning: Large date gap at index " << i
                   << " (" << data[i-1].date << " -> " << data[i].date << ")" << std::endl;
       }
     }
   }
 
   if (issues_found == 0 && gap_count == 0) {
-    std::cout << "✅ Data Integrity: All " << data.size() << " bars passed integrity checks" << std::endl;
+    Log::Line(Log::Level::Info) << "✅ Data Integrity: All " << data.size() << " bars passed integrity checks" << std::endl;
   } else {
     if (issues_found > 0) {
-      std::cout << "⚠️ Data Integrity: " << issues_found << " data issues found" << std::endl;
+      Log::Line(Log::Level::Warn) << "⚠️ Data Integrity: " << issues_found << " data issues found" << std::endl;
     }
     if (gap_count > 0) {
-      std::cout << "⚠️ Data Integrity: " << gap_count << " date gaps detected" << std::endl;
+      Log::Line(Log::Level::Warn) << "⚠️ Data Integrity: " << gap_count << " date gaps detected" << std::endl;
     }
   }
 }
 
-void StrategyTester::validate_ohlc_relationships(const std::vector<Bar>& data) {
-  std::cout << "🔍 Validating OHLC relationships in " << data.size() << " bars..." << std::endl;
+void StrategyTester::validate_ohlc_relationships(BarSpan data) {
+  Log::Line(Log::Level::Info) << "🔍 Validating OHLC relationships in " << data.size() << " bars..." << std::endl;
 
   int violations = 0;
 
@@ -648,13 +784,13 @@ void StrategyTester::validate_ohlc_relationships(const std::vector<Bar>& data) {
     // High should be >= Open, High, Low, Close
     if (bar.high < bar.open || bar.high < bar.low || bar.high < bar.close) {
       violations++;
-      std::cout << "   Error: High price violations at index " << i << std::endl;
+      Log::Line(Log::Level::Warn) << "   Error: High price violations at index " << i << std::endl;
     }
 
     // Low should be <= Open, High, Low, Close
     if (bar.low > bar.open || bar.low > bar.high || bar.low > bar.close) {
       violations++;
-      std::cout << "   Error: Low price violations at index " << i << std::endl;
+      Log::Line(Log::Level::Warn) << "   Error: Low price violations at index " << i << std::endl;
     }
 
     // Check for extreme intraday volatility (price changes > 50%)
@@ -665,36 +801,53 @@ void StrategyTester::validate_ohlc_relationships(const std::vector<Bar>& data) {
 
     if (max_change > 0.8) {  // 80% intraday change
       violations++;
-      std::cout << "   Warning: Extreme intraday volatility at index " << i
+      Log::Line(Log::Level::Warn) << "   Warning: Extreme intraday volatility at index " << i
                 << " (" << (max_change * 100) << "% change)" << std::endl;
     }
   }
 
   if (violations == 0) {
-    std::cout << "✅ OHLC Relationships: All " << data.size() << " bars have valid OHLC relationships" << std::endl;
+    Log::Line(Log::Level::Info) << "✅ OHLC Relationships: All " << data.size() << " bars have valid OHLC relationships" << std::endl;
   } else {
-    std::cout << "❌ OHLC Relationships: " << violations << " relationship violations found!" << std::endl;
+    Log::Line(Log::Level::Warn) << "❌ OHLC Relationships: " << violations << " relationship violations found!" << std::endl;
   }
 }
 
 // StrategyGeneration namespace implementations
 namespace StrategyGeneration {
 
+// Uniform integer in [lo, hi]; lo when the range is empty
+static int random_int(std::mt19937_64& rng, int lo, int hi) {
+  return std::uniform_int_distribution<int>(lo, std::max(lo, hi))(rng);
+}
+
+// Uniform real in [lo, hi)
+static double random_real(std::mt19937_64& rng, double lo, double hi) {
+  return lo + std::uniform_real_distribution<double>(0.0, 1.0)(rng) * (hi - lo);
+}
+
+// 0.01% to 0.1% in steps of 0.001%
+static double random_fee(std::mt19937_64& rng) {
+  return 0.0001 + random_int(rng, 0, 99) * 0.00001;
+}
+
 std::vector<StrategyTestConfig> generate_sma_configs(
     int num_configs,
     int short_min, int short_max,
-    int long_min, int long_max) {
+    int long_min, int long_max,
+    unsigned long long seed) {
 
   std::vector<StrategyTestConfig> configs;
 
   for (int i = 0; i < num_configs; ++i) {
+    std::mt19937_64 rng = make_config_rng(seed, static_cast<size_t>(i));
     StrategyTestConfig config;
     config.strategy_name = "SMA";
 
     // Generate random parameters
-    int short_win = short_min + (rand() % (short_max - short_min + 1));
-    int long_win = long_min + (rand() % (long_max - long_min + 1));
-    double fee = 0.0001 + (rand() % 100) * 0.00001;  // 0.01% to 0.1% fees
+    int short_win = random_int(rng, short_min, short_max);
+    int long_win = random_int(rng, long_min, long_max);
+    double fee = random_fee(rng);
 
     // Ensure short < long
     if (short_win >= long_win) {
@@ -713,22 +866,24 @@ std::vector<StrategyTestConfig> generate_rsi_configs(
     int period_min, int period_max,
     double overbought_min, double overbought_max,
     double oversold_min, double oversold_max,
-    int confirm_min, int confirm_max) {
+    int confirm_min, int confirm_max,
+    unsigned long long seed) {
 
   std::vector<StrategyTestConfig> configs;
 
   for (int i = 0; i < num_configs; ++i) {
+    std::mt19937_64 rng = make_config_rng(seed, static_cast<size_t>(i));
     StrategyTestConfig config;
     config.strategy_name = "RSI";
 
-    int period = period_min + (rand() % std::max(1, period_max - period_min + 1));
-    double overbought = overbought_min + (static_cast<double>(rand()) / RAND_MAX) * (overbought_max - overbought_min);
-    double oversold = oversold_min + (static_cast<double>(rand()) / RAND_MAX) * (oversold_max - oversold_min);
+    int period = random_int(rng, period_min, period_max);
+    double overbought = random_real(rng, overbought_min, overbought_max);
+    double oversold = random_real(rng, oversold_min, oversold_max);
     if (overbought <= oversold) {
       overbought = oversold + 5.0;
     }
-    int confirm = confirm_min + (rand() % std::max(1, confirm_max - confirm_min + 1));
-    double fee = 0.0001 + (rand() % 100) * 0.00001;
+    int confirm = random_int(rng, confirm_min, confirm_max);
+    double fee = random_fee(rng);
 
     config.parameters = {
       static_cast<double>(period),
@@ -750,23 +905,25 @@ std::vector<StrategyTestConfig> generate_macd_configs(
     int slow_min, int slow_max,
     int signal_min, int signal_max,
     double overbought_min, double overbought_max,
-    double oversold_min, double oversold_max) {
+    double oversold_min, double oversold_max,
+    unsigned long long seed) {
 
   std::vector<StrategyTestConfig> configs;
 
   for (int i = 0; i < num_configs; ++i) {
+    std::mt19937_64 rng = make_config_rng(seed, static_cast<size_t>(i));
     StrategyTestConfig config;
     config.strategy_name = "MACD";
 
-    int fast = fast_min + (rand() % std::max(1, fast_max - fast_min + 1));
-    int slow = slow_min + (rand() % std::max(1, slow_max - slow_min + 1));
+    int fast = random_int(rng, fast_min, fast_max);
+    int slow = random_int(rng, slow_min, slow_max);
     if (slow <= fast) {
       slow = fast + 4;
     }
-    int signal = signal_min + (rand() % std::max(1, signal_max - signal_min + 1));
-    double overbought = overbought_min + (static_cast<double>(rand()) / RAND_MAX) * (overbought_max - overbought_min);
-    double oversold = oversold_min + (static_cast<double>(rand()) / RAND_MAX) * (oversold_max - oversold_min);
-    double fee = 0.0001 + (rand() % 100) * 0.00001;
+    int signal = random_int(rng, signal_min, signal_max);
+    double overbought = random_real(rng, overbought_min, overbought_max);
+    double oversold = random_real(rng, oversold_min, oversold_max);
+    double fee = random_fee(rng);
 
     config.parameters = {
       static_cast<double>(fast),
@@ -783,17 +940,17 @@ std::vector<StrategyTestConfig> generate_macd_configs(
   return configs;
 }
 
-std::vector<StrategyTestConfig> generate_comprehensive_test_suite() {
+std::vector<StrategyTestConfig> generate_comprehensive_test_suite(unsigned long long seed) {
   std::vector<StrategyTestConfig> configs;
 
   // SMA strategies with various parameters
-  auto sma_configs = generate_sma_configs(50, 5, 50, 20, 200);
+  auto sma_configs = generate_sma_configs(50, 5, 50, 20, 200, seed);
   configs.insert(configs.end(), sma_configs.begin(), sma_configs.end());
 
-  auto rsi_configs = generate_rsi_configs(30, 7, 25, 65.0, 85.0, 15.0, 35.0, 1, 4);
+  auto rsi_configs = generate_rsi_configs(30, 7, 25, 65.0, 85.0, 15.0, 35.0, 1, 4, seed + 1);
   configs.insert(configs.end(), rsi_configs.begin(), rsi_configs.end());
 
-  auto macd_configs = generate_macd_configs(30, 8, 15, 20, 35, 5, 12, 0.5, 1.5, -1.5, -0.5);
+  auto macd_configs = generate_macd_configs(30, 8, 15, 20, 35, 5, 12, 0.5, 1.5, -1.5, -0.5, seed + 2);
   configs.insert(configs.end(), macd_configs.begin(), macd_configs.end());
 
   return configs;
@@ -801,7 +958,7 @@ std::vector<StrategyTestConfig> generate_comprehensive_test_suite() {
 
 StrategyMetrics quick_test_strategy(const std::string& strategy_type,
                                   const std::vector<double>& params,
-                                  const std::vector<Bar>& data) {
+                                  const BarSeries& data) {
 
   StrategyTestConfig config;
   config.strategy_name = strategy_type;
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "strategy.h"
+#include "bar_series.h"
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <memory>
 #include <functional>
+#include <random>
 
 // Strategy test configuration
 struct StrategyTestConfig {
@@ -47,8 +50,9 @@ struct StrategyMetrics {
   // Ranking score
   double composite_score = 0.0;
 
-  // Original market data for statistical validation (lookahead bias detection)
-  std::vector<Bar> market_data;
+  // Original market data for statistical validation (lookahead bias detection).
+  // Shared handle: every result of a batch references the same bars.
+  BarSeries market_data;
 
   // Helper method to calculate composite score
   void calculate_composite_score();
@@ -61,21 +65,45 @@ struct ParameterGenConfig {
   int num_samples = 100;  // Number of parameter combinations to generate
   std::string generation_method = "random";  // "random", "grid", "lhs"
   double mutation_rate = 0.1;  // For genetic algorithm approaches
+  unsigned long long seed = 123456789;  // Base seed for the per-config RNG streams
 };
 
+// Independent RNG stream for config `index` of a run seeded with `seed`.
+// Every generator below draws config i from make_config_rng(seed, i), so the
+// configs depend only on the seed, never on the thread count or on what else
+// the process has drawn.
+std::mt19937_64 make_config_rng(unsigned long long seed, size_t index);
+
 // Strategy testing framework
 class StrategyTester {
 public:
   StrategyTester() = default;
   ~StrategyTester() = default;
 
+  // Worker threads used by the batch methods (1 = serial, 0 = all cores)
+  void set_num_threads(int num_threads) { num_threads_ = num_threads; }
+  int get_num_threads() const { return num_threads_; }
+
   // Test a single strategy configuration
+  StrategyMetrics test_strategy(const StrategyTestConfig& config, const BarSeries& data);
+  // Convenience overload; copies the bars into a new BarSeries
   StrategyMetrics test_strategy(const StrategyTestConfig& config, const std::vector<Bar>& data);
+  // For bars derived from an already validated series (e.g. its permutations):
+  // skips validation, leaves metrics.market_data empty and turns off the
+  // strategy's printed results block
+  StrategyMetrics test_strategy_unchecked(const StrategyTestConfig& config, BarSpan data);
 
   // Generate multiple strategy configurations
+  // Config i draws from its own RNG stream derived from (gen_config.seed, i),
+  // so the result does not depend on the thread count.
   std::vector<StrategyTestConfig> generate_strategy_configs(const ParameterGenConfig& gen_config);
 
   // Test multiple strategies and return ranked results
+  // Runs on num_threads workers; the ranking is identical to the serial run.
+  std::vector<StrategyMetrics> test_multiple_strategies(
+      const std::vector<StrategyTestConfig>& configs,
+      const BarSeries& data);
+  // Convenience overload; the bars are copied once and shared by all results
   std::vector<StrategyMetrics> test_multiple_strategies(
       const std::vector<StrategyTestConfig>& configs,
       const std::vector<Bar>& data);
@@ -91,6 +119,10 @@ public:
       const ParameterGenConfig& gen_config);
 
 private:
+  // Shared by test_strategy and test_strategy_unchecked; validates and
+  // records `series` when it is given
+  StrategyMetrics run_test(const StrategyTestConfig& config, BarSpan data, const BarSeries* series);
+
   // Metrics calculation helpers
   double calculate_sharpe_ratio(const std::vector<double>& returns);
   double calculate_sortino_ratio(const std::vector<double>& returns);
@@ -98,11 +130,16 @@ private:
   double calculate_var(const std::vector<double>& returns, double confidence = 0.95);
   double calculate_expected_shortfall(const std::vector<double>& returns, double confidence = 0.95);
 
+  int num_threads_ = 1;
+
   // Parameter generation methods (can also be made public if needed)
-  std::vector<double> generate_random_parameters(const std::vector<std::pair<double, double>>& ranges);
+  std::vector<double> generate_random_parameters(const std::vector<std::pair<double, double>>& ranges,
+                                                 unsigned long long seed, size_t index);
 
 public:
-  static std::vector<double> generate_random_parameters_static(const std::vector<std::pair<double, double>>& ranges);
+  // Uniform draw within each range from make_config_rng(seed, index)
+  static std::vector<double> generate_random_parameters_static(const std::vector<std::pair<double, double>>& ranges,
+                                                               unsigned long long seed, size_t index);
   std::vector<double> generate_grid_parameters(const std::vector<std::pair<double, double>>& ranges, int samples);
   std::vector<double> mutate_parameters(const std::vector<double>& params, double mutation_rate);
 
@@ -112,16 +149,21 @@ public:
   // Utility methods
   std::vector<double> run_strategy_simulation(
       std::unique_ptr<Strategy>& strategy,
-      const std::vector<Bar>& data);
+      BarSpan data);
 
 public:
   void print_strategy_metrics(const StrategyMetrics& metrics);
   void print_strategy_comparison(const std::vector<StrategyMetrics>& metrics);
 
+  // Run the three checks below once per BarSeries view (see
+  // BarSeries::Validation) and replay the verdict on later calls. Throws
+  // std::runtime_error if the bars are not in chronological order.
+  static void validate_dataset(const BarSeries& data);
+
   // Data integrity validation methods
-  static void validate_chronological_order(const std::vector<Bar>& data);
-  static void validate_data_integrity(const std::vector<Bar>& data);
-  static void validate_ohlc_relationships(const std::vector<Bar>& data);
+  static void validate_chronological_order(BarSpan data);
+  static void validate_data_integrity(BarSpan data);
+  static void validate_ohlc_relationships(BarSpan data);
 };
 
 // Strategy portfolio for combining multiple strategies
@@ -142,11 +184,14 @@ struct StrategyPortfolio {
 // Global functions for easy access
 namespace StrategyGeneration {
 
+  // Config i of each generator draws from make_config_rng(seed, i)
+
   // Generate SMA strategy configurations
   std::vector<StrategyTestConfig> generate_sma_configs(
       int num_configs = 50,
       int short_min = 5, int short_max = 50,
-      int long_min = 20, int long_max = 200);
+      int long_min = 20, int long_max = 200,
+      unsigned long long seed = 123456789);
 
   // Generate RSI strategy configurations
   std::vector<StrategyTestConfig> generate_rsi_configs(
@@ -154,7 +199,8 @@ namespace StrategyGeneration {
       int period_min = 7, int period_max = 25,
       double overbought_min = 65.0, double overbought_max = 85.0,
       double oversold_min = 15.0, double oversold_max = 35.0,
-      int confirm_min = 1, int confirm_max = 4);
+      int confirm_min = 1, int confirm_max = 4,
+      unsigned long long seed = 123456789);
 
   // Generate MACD strategy configurations
   std::vector<StrategyTestConfig> generate_macd_configs(
@@ -163,14 +209,16 @@ namespace StrategyGeneration {
       int slow_min = 20, int slow_max = 35,
       int signal_min = 5, int signal_max = 12,
       double overbought_min = 0.5, double overbought_max = 1.5,
-      double oversold_min = -1.5, double oversold_max = -0.5);
+      double oversold_min = -1.5, double oversold_max = -0.5,
+      unsigned long long seed = 123456789);
 
   // Generate comprehensive strategy test suite
-  std::vector<StrategyTestConfig> generate_comprehensive_test_suite();
+  // The SMA, RSI and MACD sets use seeds seed, seed + 1 and seed + 2
+  std::vector<StrategyTestConfig> generate_comprehensive_test_suite(unsigned long long seed = 123456789);
 
   // Quick strategy testing with default parameters
   StrategyMetrics quick_test_strategy(const std::string& strategy_type,
                                     const std::vector<double>& params,
-                                    const std::vector<Bar>& data);
+                                    const BarSeries& data);
 
 }
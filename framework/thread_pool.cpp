@@ -0,0 +1,145 @@
+#include "thread_pool.h"
+
+WorkStealingPool::WorkStealingPool(int num_threads) {
+  unsigned count = resolve_thread_count(num_threads);
+
+  for (unsigned i = 0; i < count; ++i) {
+    queues_.push_back(std::make_unique<WorkerQueue>());
+  }
+
+  // A single-thread pool runs tasks inline on the caller
+  if (count > 1) {
+    for (unsigned i = 0; i < count; ++i) {
+      threads_.emplace_back(&WorkStealingPool::worker_loop, this, i);
+    }
+  }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    stop_ = true;
+  }
+  work_cv_.notify_all();
+
+  for (auto& thread : threads_) {
+    if (thread.joinable()) thread.join();
+  }
+}
+
+unsigned WorkStealingPool::resolve_thread_count(int requested) {
+  if (requested > 0) return static_cast<unsigned>(requested);
+
+  unsigned hw = std::thread::hardware_concurrency();
+  return hw > 0 ? hw : 1;
+}
+
+void WorkStealingPool::parallel_for(size_t count, const Task& task) {
+  if (count == 0) return;
+
+  if (threads_.empty()) {
+    for (size_t i = 0; i < count; ++i) {
+      task(i, 0);
+    }
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+
+    // Publish the task before any index becomes visible: a worker still
+    // draining the previous batch may pop one of these indices immediately
+    task_.store(&task);
+    remaining_ = count;
+    first_error_ = nullptr;
+
+    // Seed every worker with a contiguous block so neighbouring indices
+    // (which tend to have similar cost) start on the same core
+    size_t workers = queues_.size();
+    for (size_t w = 0; w < workers; ++w) {
+      size_t begin = count * w / workers;
+      size_t end = count * (w + 1) / workers;
+
+      std::lock_guard<std::mutex> queue_lock(queues_[w]->mutex);
+      for (size_t i = begin; i < end; ++i) {
+        queues_[w]->indices.push_back(i);
+      }
+    }
+
+    ++generation_;
+  }
+  work_cv_.notify_all();
+
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(state_mutex_);
+    done_cv_.wait(lock, [this]() { return remaining_ == 0; });
+    task_.store(nullptr);
+    error = first_error_;
+    first_error_ = nullptr;
+  }
+
+  if (error) std::rethrow_exception(error);
+}
+
+void WorkStealingPool::worker_loop(unsigned worker_id) {
+  unsigned long long seen_generation = 0;
+
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(state_mutex_);
+      work_cv_.wait(lock, [&]() { return stop_ || generation_ != seen_generation; });
+      if (stop_) return;
+      seen_generation = generation_;
+    }
+
+    size_t index;
+    while (next_index(worker_id, index)) {
+      run_index(worker_id, index);
+    }
+  }
+}
+
+bool WorkStealingPool::next_index(unsigned worker_id, size_t& index) {
+  // Own queue first (LIFO keeps the working set warm)
+  {
+    WorkerQueue& own = *queues_[worker_id];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.indices.empty()) {
+      index = own.indices.back();
+      own.indices.pop_back();
+      return true;
+    }
+  }
+
+  // Steal from the opposite end of the other queues
+  size_t workers = queues_.size();
+  for (size_t offset = 1; offset < workers; ++offset) {
+    WorkerQueue& victim = *queues_[(worker_id + offset) % workers];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.indices.empty()) {
+      index = victim.indices.front();
+      victim.indices.pop_front();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void WorkStealingPool::run_index(unsigned worker_id, size_t index) {
+  // An index can only be popped while its batch is live, so task_ is current
+  const Task* task = task_.load();
+
+  try {
+    (*task)(index, worker_id);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(state_mutex_);
+    if (!first_error_) first_error_ = std::current_exception();
+  }
+
+  std::lock_guard<std::mutex> lock(state_mutex_);
+  if (--remaining_ == 0) {
+    done_cv_.notify_all();
+  }
+}
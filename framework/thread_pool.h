@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Work-stealing thread pool for embarrassingly parallel batch work.
+//
+// parallel_for() splits the index range into one contiguous block per worker.
+// Each worker drains its own deque from the back and, once empty, steals from
+// the front of the other workers' deques, so a few slow configurations (long
+// lookbacks, many trades) do not leave the remaining cores idle.
+//
+// parallel_for() must not be called concurrently from several threads.
+class WorkStealingPool {
+public:
+  // Task receives (index, worker_id); worker_id is in [0, size()).
+  using Task = std::function<void(size_t, unsigned)>;
+
+  // num_threads <= 0 selects std::thread::hardware_concurrency().
+  explicit WorkStealingPool(int num_threads = 0);
+  ~WorkStealingPool();
+
+  WorkStealingPool(const WorkStealingPool&) = delete;
+  WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+  unsigned size() const { return static_cast<unsigned>(queues_.size()); }
+
+  // Run task(i, worker) for every i in [0, count) and block until all are done.
+  // The first exception thrown by a task is rethrown here after the batch drains.
+  void parallel_for(size_t count, const Task& task);
+
+  // Map a user-supplied thread count (0 or negative = all cores) to a real count.
+  static unsigned resolve_thread_count(int requested);
+
+private:
+  struct WorkerQueue {
+    std::mutex mutex;
+    std::deque<size_t> indices;
+  };
+
+  void worker_loop(unsigned worker_id);
+  bool next_index(unsigned worker_id, size_t& index);
+  void run_index(unsigned worker_id, size_t index);
+
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::vector<std::thread> threads_;
+
+  std::mutex state_mutex_;
+  std::condition_variable work_cv_;
+  std::condition_variable done_cv_;
+  std::atomic<const Task*> task_{nullptr};
+  unsigned long long generation_ = 0;
+  size_t remaining_ = 0;
+  std::exception_ptr first_error_;
+  bool stop_ = false;
+};
@@ -2,35 +2,37 @@
 #include <cstdlib>
 #include <cstring>
 #include <string>
-#include <ctime>
+
+#include "bar_time.h"
 
 // Convert Binance Futures kline CSV to algorithm input
 // Supports two outputs:
-//  - OHLC rows:  YYYYMMDD Open High Low Close
+//  - OHLC rows:  YYYYMMDD Open High Low Close Volume EpochMs
 //  - Close-only: YYYYMMDD Close
+// EpochMs is the kline open time in UTC milliseconds, so hourly and minute
+// bars that share a date stay distinguishable. Programs that read only the
+// first four prices ignore the trailing columns.
 // Usage:
 //   binance_to_txt [--close-only] input.csv output.txt
 // Accepts first columns as either:
-//   1) epoch_ms,open,high,low,close,...
-//   2) YYYY-MM-DD HH:MM:SS,open,high,low,close,...
+//   1) epoch_ms,open,high,low,close,volume,...   (16-digit epoch_us also accepted)
+//   2) YYYY-MM-DD HH:MM:SS,open,high,low,close,volume,...
 // Lines starting with non-digit or with headers are skipped.
 
-static bool parse_epoch_ms_to_yyyymmdd(const char* s, int* out_date) {
-  // parse up to 13 digits
+static bool parse_epoch_ms(const char* s, long long* out_ms) {
+  // parse up to 16 digits
   const char* p = s;
-  long long ms = 0;
+  long long value = 0;
   int digits = 0;
-  while (*p >= '0' && *p <= '9' && digits < 16) { ms = ms*10 + (*p - '0'); ++p; ++digits; }
+  while (*p >= '0' && *p <= '9' && digits < 16) { value = value*10 + (*p - '0'); ++p; ++digits; }
   if (digits < 10) return false;
-  time_t secs = (time_t)(ms / 1000);
-  struct tm t; memset(&t, 0, sizeof(t));
-  if (!gmtime_r(&secs, &t)) return false;
-  *out_date = (t.tm_year + 1900) * 10000 + (t.tm_mon + 1) * 100 + t.tm_mday;
+  if (digits >= 16) value /= 1000;  // Newer dumps use microseconds
+  *out_ms = value;
   return true;
 }
 
-static bool parse_iso_to_yyyymmdd(const char* s, int* out_date) {
-  // Expect: YYYY-MM-DD ...
+static bool parse_iso_to_epoch_ms(const char* s, long long* out_ms) {
+  // Expect: YYYY-MM-DD[ HH:MM[:SS]] ...
   if (std::strlen(s) < 10) return false;
   if (!(s[0]>='0'&&s[0]<='9')) return false;
   if (!(s[1]>='0'&&s[1]<='9')) return false;
@@ -41,7 +43,11 @@ static bool parse_iso_to_yyyymmdd(const char* s, int* out_date) {
   int y = (s[0]-'0')*1000 + (s[1]-'0')*100 + (s[2]-'0')*10 + (s[3]-'0');
   int m = (s[5]-'0')*10 + (s[6]-'0');
   int d = (s[8]-'0')*10 + (s[9]-'0');
-  *out_date = y*10000 + m*100 + d;
+  int hh = 0, mm = 0, ss = 0;
+  if ((s[10] == ' ' || s[10] == 'T') && std::sscanf(s + 11, "%d:%d:%d", &hh, &mm, &ss) < 2) {
+    hh = mm = ss = 0;
+  }
+  *out_ms = bar_days_from_civil(y, m, d) * BAR_MS_PER_DAY + ((hh * 60LL + mm) * 60LL + ss) * 1000LL;
   return true;
 }
 
@@ -91,23 +97,24 @@ int main(int argc, char** argv) {
     }
     if (ncols < 5) continue; // need at least 5 columns
 
-    int yyyymmdd = 0;
-    bool ok_date = false;
+    long long epoch_ms = 0;
     // Try ISO first, then epoch ms
-    ok_date = parse_iso_to_yyyymmdd(cols[0], &yyyymmdd) || parse_epoch_ms_to_yyyymmdd(cols[0], &yyyymmdd);
+    bool ok_date = parse_iso_to_epoch_ms(cols[0], &epoch_ms) || parse_epoch_ms(cols[0], &epoch_ms);
     if (!ok_date) continue;
+    int yyyymmdd = bar_epoch_ms_to_date(epoch_ms);
 
     char* end = nullptr;
     double open = std::strtod(cols[1], &end);
     double high = std::strtod(cols[2], &end);
     double low  = std::strtod(cols[3], &end);
     double close = std::strtod(cols[4], &end);
+    double volume = ncols > 5 ? std::strtod(cols[5], &end) : 0.0;
     if (!(open > 0 && high > 0 && low > 0 && close > 0)) continue;
 
     if (close_only) {
       std::fprintf(fo, "%08d %.8f\n", yyyymmdd, close);
     } else {
-      std::fprintf(fo, "%08d %.8f %.8f %.8f %.8f\n", yyyymmdd, open, high, low, close);
+      std::fprintf(fo, "%08d %.8f %.8f %.8f %.8f %.8f %lld\n", yyyymmdd, open, high, low, close, volume, epoch_ms);
     }
     ++written;
   }
@@ -0,0 +1,154 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "bar_store.h"
+#include "bar_time.h"
+
+// Convert a text market history to a binary columnar bar store (.bars)
+// Accepts the formats read by the algorithm programs:
+//  - OHLC rows:  YYYYMMDD Open High Low Close [Volume [EpochMs]]
+//  - Close-only: YYYYMMDD Price   (stored as Open = High = Low = Close)
+// Rows without an epoch-millisecond timestamp get midnight UTC of their date.
+// Fields may be separated by spaces, tabs or commas.
+// A row whose high and low do not bracket its open and close is an error.
+// Usage:
+//   txt_to_bars input.txt output.bars
+//   txt_to_bars --info file.bars
+// Any program that reads a market file also accepts the .bars output.
+
+static const char* skip_delims(const char* p) {
+  while (*p == ' ' || *p == '\t' || *p == ',') ++p;
+  return p;
+}
+
+static int print_info(const char* filename) {
+  std::string err;
+  BarStore store;
+  if (bar_store_open(filename, &store, &err)) {
+    std::fprintf(stderr, "%s\n", err.c_str());
+    return 1;
+  }
+
+  static const char* names[BAR_COL_COUNT] = {"date", "open", "high", "low", "close", "volume", "timestamp"};
+  const void* cols[BAR_COL_COUNT] = {store.date, store.open, store.high, store.low, store.close, store.volume,
+                                     store.timestamp};
+
+  std::printf("%s: %lld rows, version %d, checksum OK\n", filename, (long long) store.nrows, BAR_STORE_VERSION);
+  std::printf("columns:");
+  for (int col = 0; col < BAR_COL_COUNT; ++col) {
+    if (cols[col]) std::printf(" %s", names[col]);
+  }
+  std::printf("\n");
+  if (store.nrows > 0 && store.date) {
+    std::printf("dates: %08d .. %08d\n", store.date[0], store.date[store.nrows - 1]);
+  }
+  if (store.nrows > 0 && store.timestamp) {
+    std::printf("timestamps: %lld .. %lld\n", (long long) store.timestamp[0],
+                (long long) store.timestamp[store.nrows - 1]);
+  }
+
+  bar_store_close(&store);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc == 3 && std::strcmp(argv[1], "--info") == 0) {
+    return print_info(argv[2]);
+  }
+  if (argc != 3) {
+    std::fprintf(stderr, "Usage: %s input.txt output.bars\n       %s --info file.bars\n", argv[0], argv[0]);
+    return 2;
+  }
+  const char* in = argv[1];
+  const char* out = argv[2];
+
+  FILE* fi = nullptr;
+  if (fopen_s(&fi, in, "rt")) { std::fprintf(stderr, "Cannot open input %s\n", in); return 1; }
+
+  std::vector<int32_t> date;
+  std::vector<double> open, high, low, close, volume;
+  std::vector<int64_t> timestamp;
+
+  char line[4096];
+  int count = 0, skipped = 0;
+  while (std::fgets(line, sizeof(line), fi)) {
+    ++count;
+    if (std::strlen(line) < 2) continue;
+
+    int yyyymmdd = 0;
+    bool ok = true;
+    for (int i = 0; i < 8; ++i) {
+      if (line[i] < '0' || line[i] > '9') { ok = false; break; }
+      yyyymmdd = yyyymmdd * 10 + (line[i] - '0');
+    }
+    if (!ok) { ++skipped; continue; }
+
+    // Up to five prices/volume after the date token, then the timestamp
+    double values[5];
+    int nvalues = 0;
+    const char* p = line + 8;
+    while (*p && *p != ' ' && *p != '\t' && *p != ',' && *p != '\r' && *p != '\n') ++p;
+    for (;;) {
+      p = skip_delims(p);
+      if (nvalues == 5 || *p == '\0' || *p == '\r' || *p == '\n') break;
+      char* end = nullptr;
+      values[nvalues] = std::strtod(p, &end);
+      if (end == p) break;
+      ++nvalues;
+      p = end;
+    }
+
+    int64_t ts = 0;
+    if (nvalues == 5) {
+      p = skip_delims(p);
+      char* end = nullptr;
+      long long parsed = std::strtoll(p, &end, 10);
+      if (end != p) ts = (int64_t) parsed;
+    }
+    if (ts == 0) ts = bar_date_to_epoch_ms(yyyymmdd);
+
+    if (nvalues == 1) {
+      values[1] = values[2] = values[3] = values[0];
+      values[4] = 0.0;
+    } else if (nvalues == 4) {
+      values[4] = 0.0;
+    } else if (nvalues != 5) {
+      ++skipped;
+      continue;
+    }
+
+    // The OHLC readers stop on such a row, so do not store one
+    if (!bar_store_ohlc_ok(values[0], values[1], values[2], values[3])) {
+      std::fprintf(stderr, "Invalid open/high/low/close in line %d of %s\n", count, in);
+      std::fclose(fi);
+      return 1;
+    }
+
+    date.push_back(yyyymmdd);
+    open.push_back(values[0]);
+    high.push_back(values[1]);
+    low.push_back(values[2]);
+    close.push_back(values[3]);
+    volume.push_back(values[4]);
+    timestamp.push_back(ts);
+  }
+  std::fclose(fi);
+
+  if (date.empty()) {
+    std::fprintf(stderr, "No valid rows in %s\n", in);
+    return 1;
+  }
+
+  std::string err;
+  if (bar_store_write(out, (int64_t) date.size(), date.data(), open.data(), high.data(),
+                      low.data(), close.data(), volume.data(), timestamp.data(), &err)) {
+    std::fprintf(stderr, "%s\n", err.c_str());
+    return 1;
+  }
+
+  std::fprintf(stderr, "Converted %d lines, wrote %zu rows, skipped %d\n", count, date.size(), skipped);
+  return 0;
+}